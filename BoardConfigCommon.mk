@@ -117,5 +117,15 @@ PRODUCT_EXTRA_VNDK_VERSIONS := 28
 BOARD_AVB_ENABLE := true
 BOARD_AVB_MAKE_VBMETA_IMAGE_ARGS += --flag 3
 
+# Vibrator
+# SOONG_CONFIG_MEIZU_SM8150_VIBRATOR_AIDL is set by the device makefile
+# before it inherits common.mk, which picks the service to install. The
+# AIDL service needs Android 11 or later, and its manifest entry is only
+# added with it, since older libvintf cannot parse AIDL HALs.
+SOONG_CONFIG_NAMESPACES += MEIZU_SM8150_VIBRATOR
+SOONG_CONFIG_MEIZU_SM8150_VIBRATOR := AIDL
+DEVICE_FRAMEWORK_MANIFEST_FILE += \
+    $(if $(filter true,$(SOONG_CONFIG_MEIZU_SM8150_VIBRATOR_AIDL)),$(COMMON_PATH)/vibrator/aidl/framework_manifest.xml)
+
 # Inherit from the proprietary version
 -include vendor/meizu/sm8150-common/BoardConfigVendor.mk
@@ -78,8 +78,16 @@ PRODUCT_BOOT_JARS += \
     telephony-ext
 
 # Vibrator
+# Devices on Android 11 or later set SOONG_CONFIG_MEIZU_SM8150_VIBRATOR_AIDL := true
+# before inheriting this file, to install the AIDL service in place of the
+# HIDL one. See BoardConfigCommon.mk.
+ifeq ($(SOONG_CONFIG_MEIZU_SM8150_VIBRATOR_AIDL),true)
+PRODUCT_PACKAGES += \
+    android.hardware.vibrator-service.meizu_sm8150
+else
 PRODUCT_PACKAGES += \
     android.hardware.vibrator@1.2-service.meizu_sm8150
+endif
 
 # VNDK-SP
 PRODUCT_PACKAGES += \
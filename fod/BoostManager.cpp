@@ -0,0 +1,132 @@
+/*
+ * Copyright (C) 2020 The MoKee Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "FingerprintInscreenService"
+
+#include "BoostManager.h"
+
+#include <android-base/stringprintf.h>
+
+using ::android::base::StringAppendF;
+using ::meizu::sm8150::monotonicNs;
+
+namespace vendor {
+namespace mokee {
+namespace biometrics {
+namespace fingerprint {
+namespace inscreen {
+namespace V1_0 {
+namespace implementation {
+
+BoostManager::BoostManager(const std::string& qosPath, uint32_t timeoutMs)
+    : mQos(qosPath),
+      mTimeoutMs(timeoutMs),
+      mDeadlineNs(0),
+      mBoostedNs(0),
+      mTimeouts(0),
+      mThread("boost timeout", [this] { return checkDeadline(); }) {}
+
+BoostManager::~BoostManager() {
+    mThread.stop();
+
+    releaseAll();
+}
+
+void BoostManager::acquire(Reason reason) {
+    std::lock_guard<std::mutex> lock(mLock);
+
+    mHeld.set(static_cast<size_t>(reason));
+    mDeadlineNs = monotonicNs() + mTimeoutMs * 1000000LL;
+    setBoostLocked(true);
+    mThread.wake();
+}
+
+void BoostManager::release(Reason reason) {
+    std::lock_guard<std::mutex> lock(mLock);
+
+    mHeld.reset(static_cast<size_t>(reason));
+    if (mHeld.none()) {
+        setBoostLocked(false);
+    }
+}
+
+void BoostManager::releaseAll() {
+    std::lock_guard<std::mutex> lock(mLock);
+
+    mHeld.reset();
+    setBoostLocked(false);
+}
+
+void BoostManager::setBoostLocked(bool on) {
+    if (on) {
+        // Written even while boosted, the driver may have timed it out already.
+        mQos.invalidate();
+        mQos.write(1);
+        if (mBoostedNs == 0) {
+            mBoostedNs = monotonicNs();
+        }
+        return;
+    }
+
+    if (mBoostedNs == 0) {
+        return;
+    }
+
+    mQos.write(0);
+    mHeldTime.record(monotonicNs() - mBoostedNs);
+    mBoostedNs = 0;
+}
+
+void BoostManager::resetStats() {
+    mHeldTime.reset();
+    mTimeouts.store(0, std::memory_order_relaxed);
+}
+
+std::string BoostManager::dump() const {
+    std::string out = mHeldTime.dump("boost held");
+
+    StringAppendF(&out, "boost timeouts=%llu\n",
+                  static_cast<unsigned long long>(mTimeouts.load(std::memory_order_relaxed)));
+    return out;
+}
+
+/*
+ * Drops the boost once its deadline has passed. Returns the deadline while
+ * the boost is held, or 0 while it is off.
+ */
+int64_t BoostManager::checkDeadline() {
+    std::lock_guard<std::mutex> lock(mLock);
+
+    if (mBoostedNs == 0) {
+        return 0;
+    }
+    if (mDeadlineNs > monotonicNs()) {
+        return mDeadlineNs;
+    }
+
+    mHeld.reset();
+    setBoostLocked(false);
+    mTimeouts.fetch_add(1, std::memory_order_relaxed);
+    return 0;
+}
+
+}  // namespace implementation
+}  // namespace V1_0
+}  // namespace inscreen
+}  // namespace fingerprint
+}  // namespace biometrics
+}  // namespace mokee
+}  // namespace vendor
@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2020 The MoKee Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef VENDOR_MOKEE_BIOMETRICS_FINGERPRINT_INSCREEN_V1_0_BOOSTMANAGER_H
+#define VENDOR_MOKEE_BIOMETRICS_FINGERPRINT_INSCREEN_V1_0_BOOSTMANAGER_H
+
+#include <atomic>
+#include <bitset>
+#include <meizu/LatencyHistogram.h>
+#include <meizu/SysfsNode.h>
+#include <meizu/TimerThread.h>
+#include <mutex>
+#include <string>
+
+namespace vendor {
+namespace mokee {
+namespace biometrics {
+namespace fingerprint {
+namespace inscreen {
+namespace V1_0 {
+namespace implementation {
+
+using ::meizu::sm8150::LatencyHistogram;
+using ::meizu::sm8150::SysfsNode;
+using ::meizu::sm8150::TimerThread;
+
+/*
+ * Holds the fingerprint QoS boost while any reason needs it.
+ *
+ * Each reason holds at most one reference, so a repeated acquire() does
+ * not leak. Every acquire() pushes the deadline out, and once it passes
+ * the boost is dropped whatever still holds it, so a lock screen left
+ * showing the FOD view does not keep the boost forever.
+ *
+ * The boost is the Meizu qos_set node. The driver may time it out on its
+ * own, so every acquire() writes it again.
+ */
+class BoostManager {
+  public:
+    enum class Reason {
+        SHOW,
+        PRESS,
+        COUNT,
+    };
+
+    BoostManager(const std::string& qosPath, uint32_t timeoutMs);
+    ~BoostManager();
+
+    void acquire(Reason reason);
+    void release(Reason reason);
+    void releaseAll();
+
+    void resetStats();
+    std::string dump() const;
+
+  private:
+    void setBoostLocked(bool on);
+    int64_t checkDeadline();
+
+    SysfsNode mQos;
+    const uint32_t mTimeoutMs;
+
+    std::mutex mLock;
+    std::bitset<static_cast<size_t>(Reason::COUNT)> mHeld;
+    int64_t mDeadlineNs;
+    int64_t mBoostedNs;
+
+    LatencyHistogram mHeldTime;
+    std::atomic<uint64_t> mTimeouts;
+
+    TimerThread mThread;
+};
+
+}  // namespace implementation
+}  // namespace V1_0
+}  // namespace inscreen
+}  // namespace fingerprint
+}  // namespace biometrics
+}  // namespace mokee
+}  // namespace vendor
+
+#endif  // VENDOR_MOKEE_BIOMETRICS_FINGERPRINT_INSCREEN_V1_0_BOOSTMANAGER_H
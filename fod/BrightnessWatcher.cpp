@@ -0,0 +1,141 @@
+/*
+ * Copyright (C) 2020 The MoKee Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "FingerprintInscreenService"
+
+#include "BrightnessWatcher.h"
+
+#include <android-base/logging.h>
+#include <android-base/parseint.h>
+#include <android-base/strings.h>
+#include <fcntl.h>
+#include <linux/magic.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/vfs.h>
+#include <unistd.h>
+
+namespace vendor {
+namespace mokee {
+namespace biometrics {
+namespace fingerprint {
+namespace inscreen {
+namespace V1_0 {
+namespace implementation {
+
+BrightnessWatcher::BrightnessWatcher(const std::string& path)
+    : mPath(path),
+      mFd(TEMP_FAILURE_RETRY(open(path.c_str(), O_RDONLY | O_CLOEXEC))),
+      mEventFd(eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK)),
+      mBrightness(0),
+      mUpdates(0),
+      mWatching(false) {
+    if (mFd < 0 || mEventFd < 0) {
+        PLOG(ERROR) << "Failed to set up brightness watcher for " << path;
+        return;
+    }
+
+    // Reading the node also arms the first poll() notification.
+    read();
+
+    // Only sysfs raises POLLPRI, a fake tree on a regular filesystem never would.
+    struct statfs fs;
+    if (fstatfs(mFd, &fs) != 0 || fs.f_type != SYSFS_MAGIC) {
+        LOG(INFO) << path << " is not on sysfs, reading it on every call";
+        return;
+    }
+
+    mWatching.store(true, std::memory_order_relaxed);
+    mThread = std::thread(&BrightnessWatcher::threadLoop, this);
+}
+
+BrightnessWatcher::~BrightnessWatcher() {
+    if (mThread.joinable()) {
+        uint64_t one = 1;
+        if (write(mEventFd, &one, sizeof(one)) < 0) {
+            PLOG(ERROR) << "Failed to stop brightness watcher";
+        }
+        mThread.join();
+    }
+
+    if (mFd >= 0) {
+        close(mFd);
+    }
+    if (mEventFd >= 0) {
+        close(mEventFd);
+    }
+}
+
+int32_t BrightnessWatcher::brightness() {
+    if (!watching() && mFd >= 0) {
+        read();
+    }
+    return mBrightness.load(std::memory_order_relaxed);
+}
+
+bool BrightnessWatcher::read() {
+    char buf[16];
+    int32_t value;
+
+    ssize_t len = TEMP_FAILURE_RETRY(pread(mFd, buf, sizeof(buf) - 1, 0));
+    if (len <= 0) {
+        PLOG(ERROR) << "Failed to read " << mPath;
+        return false;
+    }
+    buf[len] = '\0';
+
+    if (!android::base::ParseInt(android::base::Trim(buf), &value)) {
+        LOG(ERROR) << "Invalid brightness in " << mPath << ": " << buf;
+        return false;
+    }
+
+    mBrightness.store(value, std::memory_order_relaxed);
+    mUpdates.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+void BrightnessWatcher::threadLoop() {
+    struct pollfd fds[] = {
+            {.fd = mEventFd, .events = POLLIN, .revents = 0},
+            {.fd = mFd, .events = POLLPRI | POLLERR, .revents = 0},
+    };
+
+    for (;;) {
+        if (poll(fds, 2, -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            PLOG(ERROR) << "Brightness watcher poll failed";
+            mWatching.store(false, std::memory_order_relaxed);
+            return;
+        }
+
+        if (fds[0].revents & POLLIN) {
+            return;
+        }
+        if (fds[1].revents & (POLLPRI | POLLERR)) {
+            read();
+        }
+    }
+}
+
+}  // namespace implementation
+}  // namespace V1_0
+}  // namespace inscreen
+}  // namespace fingerprint
+}  // namespace biometrics
+}  // namespace mokee
+}  // namespace vendor
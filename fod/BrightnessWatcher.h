@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2020 The MoKee Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef VENDOR_MOKEE_BIOMETRICS_FINGERPRINT_INSCREEN_V1_0_BRIGHTNESSWATCHER_H
+#define VENDOR_MOKEE_BIOMETRICS_FINGERPRINT_INSCREEN_V1_0_BRIGHTNESSWATCHER_H
+
+#include <atomic>
+#include <string>
+#include <thread>
+
+namespace vendor {
+namespace mokee {
+namespace biometrics {
+namespace fingerprint {
+namespace inscreen {
+namespace V1_0 {
+namespace implementation {
+
+/*
+ * Keeps the last panel brightness in memory.
+ *
+ * The backlight class notifies sysfs pollers of actual_brightness on every
+ * change, so a thread blocks in poll() on it and refreshes the cached value.
+ * Readers never touch sysfs. If the node cannot be polled, or is not on
+ * sysfs as in a fake tree, brightness() falls back to reading it on each
+ * call.
+ */
+class BrightnessWatcher {
+  public:
+    explicit BrightnessWatcher(const std::string& path);
+    ~BrightnessWatcher();
+
+    int32_t brightness();
+
+    uint64_t updates() const { return mUpdates.load(std::memory_order_relaxed); }
+    bool watching() const { return mWatching.load(std::memory_order_relaxed); }
+
+  private:
+    bool read();
+    void threadLoop();
+
+    std::string mPath;
+    int mFd;
+    int mEventFd;
+
+    std::atomic<int32_t> mBrightness;
+    std::atomic<uint64_t> mUpdates;
+    std::atomic<bool> mWatching;
+
+    std::thread mThread;
+};
+
+}  // namespace implementation
+}  // namespace V1_0
+}  // namespace inscreen
+}  // namespace fingerprint
+}  // namespace biometrics
+}  // namespace mokee
+}  // namespace vendor
+
+#endif  // VENDOR_MOKEE_BIOMETRICS_FINGERPRINT_INSCREEN_V1_0_BRIGHTNESSWATCHER_H
@@ -18,11 +18,15 @@
 #define LOG_TAG "FingerprintInscreenService"
 
 #include "FingerprintInscreen.h"
+#include <android-base/file.h>
 #include <android-base/logging.h>
+#include <android-base/stringprintf.h>
 #include <hidl/HidlTransportSupport.h>
-#include <fstream>
+#include <algorithm>
+#include <array>
 #include <cmath>
 
+#define FINGERPRINT_ACQUIRED_GOOD 0
 #define FINGERPRINT_ACQUIRED_VENDOR 6
 
 #define NOTIFY_FINGER_DOWN 1536
@@ -34,7 +38,14 @@
 
 #define BOOST_ENABLE_PATH "/sys/class/meizu/fp/qos_set"
 #define HBM_ENABLE_PATH "/sys/class/meizu/lcm/display/hbm"
-#define BRIGHTNESS_PATH "/sys/class/backlight/panel0-backlight/brightness"
+#define BRIGHTNESS_PATH "/sys/class/backlight/panel0-backlight/actual_brightness"
+
+// Panel brightness levels, 0 to 1023.
+#define BRIGHTNESS_LEVELS 1024
+
+using android::base::StringAppendF;
+using android::base::WriteStringToFd;
+using meizu::sm8150::monotonicNs;
 
 namespace vendor {
 namespace mokee {
@@ -45,25 +56,31 @@ namespace V1_0 {
 namespace implementation {
 
 /*
- * Write value to path and close file.
+ * Dim layer alpha for each panel brightness level, so that the dimmed
+ * HBM frame looks as bright as the panel did before.
  */
-template <typename T>
-static void set(const std::string& path, const T& value) {
-    std::ofstream file(path);
-    file << value;
-}
-
-template <typename T>
-static T get(const std::string& path, const T& def) {
-    std::ifstream file(path);
-    T result;
-
-    file >> result;
-    return file.fail() ? def : result;
-}
-
-FingerprintInscreen::FingerprintInscreen() {
-    this->mGoodixFpDaemon = IGoodixFingerprintDaemon::getService();
+static const std::array<int32_t, BRIGHTNESS_LEVELS>& dimAmounts() {
+    static const std::array<int32_t, BRIGHTNESS_LEVELS> table = [] {
+        std::array<int32_t, BRIGHTNESS_LEVELS> t;
+        for (size_t i = 0; i < t.size(); i++) {
+            float alpha = 1.0 - pow(i / 1023.0f, 0.455);
+            t[i] = 255.0f * alpha;
+        }
+        return t;
+    }();
+    return table;
+}
+
+FingerprintInscreen::FingerprintInscreen(const Config& config)
+    : mGoodixFpDaemon(config.daemonLookup),
+      mHbm(config.sysfsRoot + HBM_ENABLE_PATH),
+      mBrightness(config.sysfsRoot + BRIGHTNESS_PATH),
+      mBoost(config.sysfsRoot + BOOST_ENABLE_PATH, config.boostTimeoutMs) {
+    // Built here so that the first FOD show does not pay for it.
+    dimAmounts();
+
+    // Start with HBM off, which also opens the node ahead of the first press.
+    mHbm.write(0);
 }
 
 Return<int32_t> FingerprintInscreen::getPositionX() {
@@ -87,33 +104,64 @@ Return<void> FingerprintInscreen::onFinishEnroll() {
 }
 
 Return<void> FingerprintInscreen::onPress() {
-    set(HBM_ENABLE_PATH, 1);
-    notifyHal(NOTIFY_FINGER_DOWN);
+    int64_t startNs = monotonicNs();
+    uint32_t session = mTimeline.begin();
+
+    // The daemon starts capturing on finger down, so the panel must be in HBM by then.
+    mHbm.write(1);
+    int64_t hbmNs = monotonicNs();
+    mTimeline.mark(session, Timeline::Stage::HBM_ON);
+    mGoodixFpDaemon.post(NOTIFY_FINGER_DOWN, [this, session] {
+        mTimeline.mark(session, Timeline::Stage::FINGER_DOWN_SENT);
+    });
+    int64_t notifiedNs = monotonicNs();
+    mBoost.acquire(BoostManager::Reason::PRESS);
+
+    mPressHbm.record(hbmNs - startNs);
+    mPressNotify.record(notifiedNs - hbmNs);
     return Void();
 }
 
 Return<void> FingerprintInscreen::onRelease() {
-    set(HBM_ENABLE_PATH, 0);
+    int64_t startNs = monotonicNs();
+
+    mHbm.write(0);
+    mReleaseHbm.record(monotonicNs() - startNs);
     notifyHal(NOTIFY_FINGER_UP);
+    mBoost.release(BoostManager::Reason::PRESS);
+    mTimeline.mark(mTimeline.current(), Timeline::Stage::RELEASE);
     return Void();
 }
 
 Return<void> FingerprintInscreen::onShowFODView() {
-    set(BOOST_ENABLE_PATH, 1);
+    // The panel driver drops HBM on its own when the screen turns off.
+    mHbm.invalidate();
+    mBoost.acquire(BoostManager::Reason::SHOW);
     notifyHal(NOTIFY_UI_READY);
     return Void();
 }
 
 Return<void> FingerprintInscreen::onHideFODView() {
+    mBoost.releaseAll();
     notifyHal(NOTIFY_UI_DISAPPER);
     return Void();
 }
 
-Return<bool> FingerprintInscreen::handleAcquired(int32_t, int32_t) {
+/*
+ * HBM and the QoS boost are held until onRelease(), not dropped on
+ * ACQUIRED_GOOD: the finger may still be down, and a retry or a second
+ * capture would then run without HBM.
+ */
+Return<bool> FingerprintInscreen::handleAcquired(int32_t acquiredInfo, int32_t) {
+    if (acquiredInfo == FINGERPRINT_ACQUIRED_GOOD) {
+        mTimeline.mark(mTimeline.current(), Timeline::Stage::CAPTURED);
+    }
     return false;
 }
 
 Return<bool> FingerprintInscreen::handleError(int32_t, int32_t) {
+    // Whatever failed, matching is over until the next press.
+    mBoost.releaseAll();
     return false;
 }
 
@@ -122,26 +170,65 @@ Return<void> FingerprintInscreen::setLongPressEnabled(bool) {
 }
 
 Return<int32_t> FingerprintInscreen::getDimAmount(int32_t) {
-    int brightness = get(BRIGHTNESS_PATH, 0);
-    float alpha = 1.0 - pow(brightness / 1023.0f, 0.455);
-    return 255.0f * alpha;
+    int32_t brightness = std::clamp(mBrightness.brightness(), 0, BRIGHTNESS_LEVELS - 1);
+    return dimAmounts()[brightness];
 }
 
 Return<bool> FingerprintInscreen::shouldBoostBrightness() {
     return false;
 }
 
+/*
+ * Nothing is forwarded to the callback. The Goodix daemon holds a single
+ * setNotify() callback, which belongs to the vendor fingerprint HAL, so
+ * this HAL never sees daemon messages.
+ */
 Return<void> FingerprintInscreen::setCallback(const sp<IFingerprintInscreenCallback>&) {
     return Void();
 }
 
-void FingerprintInscreen::notifyHal(int32_t cmd) {
-    hidl_vec<int8_t> data;
-    Return<void> ret = this->mGoodixFpDaemon->sendCommand(cmd, data, [&](int32_t, const hidl_vec<int8_t>&) {
-    });
-    if (!ret.isOk()) {
-        LOG(ERROR) << "notifyHal(" << cmd << ") error: " << ret.description();
+// Methods from ::android::hidl::base::V1_0::IBase follow.
+Return<void> FingerprintInscreen::debug(const hidl_handle& handle,
+                                        const hidl_vec<hidl_string>& args) {
+    const native_handle_t* nativeHandle = handle.getNativeHandle();
+    if (nativeHandle == nullptr || nativeHandle->numFds < 1) {
+        LOG(ERROR) << "debug: invalid handle";
+        return Void();
     }
+
+    for (const auto& arg : args) {
+        if (arg == "--reset") {
+            mGoodixFpDaemon.resetStats();
+            mPressNotify.reset();
+            mPressHbm.reset();
+            mReleaseHbm.reset();
+            mBoost.resetStats();
+            mTimeline.reset();
+        }
+    }
+
+    std::string out = mGoodixFpDaemon.dump();
+    out += mPressNotify.dump("press notify");
+    out += mPressHbm.dump("press hbm write");
+    out += mReleaseHbm.dump("release hbm write");
+    out += mBoost.dump();
+    out += mTimeline.dump();
+    StringAppendF(&out, "brightness: %d watching=%d updates=%llu\n", mBrightness.brightness(),
+                  mBrightness.watching(), static_cast<unsigned long long>(mBrightness.updates()));
+    StringAppendF(&out, "%s: cache hits=%llu misses=%llu\n", mHbm.path().c_str(),
+                  static_cast<unsigned long long>(mHbm.cacheHits()),
+                  static_cast<unsigned long long>(mHbm.cacheMisses()));
+
+    WriteStringToFd(out, nativeHandle->data[0]);
+    return Void();
+}
+
+/*
+ * Commands are sent in order from the daemon handle's worker, so the
+ * binder call never holds up the caller. Errors are logged and counted there.
+ */
+void FingerprintInscreen::notifyHal(int32_t cmd) {
+    mGoodixFpDaemon.post(cmd);
 }
 
 }  // namespace implementation
@@ -17,8 +17,16 @@
 #ifndef VENDOR_MOKEE_BIOMETRICS_FINGERPRINT_INSCREEN_V1_0_FINGERPRINTINSCREEN_H
 #define VENDOR_MOKEE_BIOMETRICS_FINGERPRINT_INSCREEN_V1_0_FINGERPRINTINSCREEN_H
 
+#include <meizu/LatencyHistogram.h>
+#include <meizu/SysfsNode.h>
 #include <vendor/mokee/biometrics/fingerprint/inscreen/1.0/IFingerprintInscreen.h>
-#include <vendor/goodix/hardware/biometrics/fingerprint/2.1/IGoodixFingerprintDaemon.h>
+
+#include <string>
+
+#include "BoostManager.h"
+#include "BrightnessWatcher.h"
+#include "GoodixDaemon.h"
+#include "Timeline.h"
 
 namespace vendor {
 namespace mokee {
@@ -31,13 +39,25 @@ namespace implementation {
 using ::android::sp;
 using ::android::hardware::Return;
 using ::android::hardware::Void;
+using ::android::hardware::hidl_handle;
+using ::android::hardware::hidl_string;
 using ::android::hardware::hidl_vec;
 
-using ::vendor::goodix::hardware::biometrics::fingerprint::V2_1::IGoodixFingerprintDaemon;
+using ::meizu::sm8150::LatencyHistogram;
+using ::meizu::sm8150::SysfsNode;
 
 class FingerprintInscreen : public IFingerprintInscreen {
   public:
-    FingerprintInscreen();
+    struct Config {
+        // Prepended to every sysfs path.
+        std::string sysfsRoot;
+        // Finds the Goodix daemon, the registered service if unset.
+        GoodixDaemon::Lookup daemonLookup;
+        // The QoS boost is dropped this long after the last FOD show or press.
+        uint32_t boostTimeoutMs = 2000;
+    };
+
+    explicit FingerprintInscreen(const Config& config);
 
     Return<int32_t> getPositionX() override;
     Return<int32_t> getPositionY() override;
@@ -55,8 +75,22 @@ class FingerprintInscreen : public IFingerprintInscreen {
     Return<bool> shouldBoostBrightness() override;
     Return<void> setCallback(const sp<IFingerprintInscreenCallback>& callback) override;
 
+    // Methods from ::android::hidl::base::V1_0::IBase follow.
+    Return<void> debug(const hidl_handle& handle, const hidl_vec<hidl_string>& args) override;
+
   private:
-    sp<IGoodixFingerprintDaemon> mGoodixFpDaemon;
+    // Marked from the daemon command worker, so it must outlive mGoodixFpDaemon.
+    Timeline mTimeline;
+
+    GoodixDaemon mGoodixFpDaemon;
+    SysfsNode mHbm;
+    BrightnessWatcher mBrightness;
+    BoostManager mBoost;
+
+    // Time spent in each stage of onPress() and onRelease().
+    LatencyHistogram mPressNotify;
+    LatencyHistogram mPressHbm;
+    LatencyHistogram mReleaseHbm;
 
     void notifyHal(int32_t cmd);
 };
@@ -0,0 +1,216 @@
+/*
+ * Copyright (C) 2020 The MoKee Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "FingerprintInscreenService"
+
+#include "GoodixDaemon.h"
+
+#include <android-base/logging.h>
+#include <android-base/stringprintf.h>
+#include <algorithm>
+#include <chrono>
+
+namespace vendor {
+namespace mokee {
+namespace biometrics {
+namespace fingerprint {
+namespace inscreen {
+namespace V1_0 {
+namespace implementation {
+
+using ::android::base::StringAppendF;
+using ::android::hardware::hidl_vec;
+using ::android::hardware::Return;
+using ::meizu::sm8150::monotonicNs;
+
+// Lookup retry backoff while the daemon is not registered.
+static constexpr auto kRetryMin = std::chrono::milliseconds(50);
+static constexpr auto kRetryMax = std::chrono::seconds(2);
+
+void GoodixDaemon::DeathRecipient::serviceDied(
+        uint64_t cookie, const ::android::wp<::android::hidl::base::V1_0::IBase> &) {
+    LOG(ERROR) << "Goodix fingerprint daemon died";
+    mDaemon->disconnect(cookie);
+}
+
+GoodixDaemon::GoodixDaemon(Lookup lookup)
+    : mLookup(lookup ? std::move(lookup) : [] { return IGoodixFingerprintDaemon::tryGetService(); }),
+      mGeneration(0),
+      mExit(false),
+      mDeathRecipient(new DeathRecipient(this)),
+      mDropped(0),
+      mReconnects(0),
+      mCommandExit(false) {
+    mThread = std::thread(&GoodixDaemon::threadLoop, this);
+    mCommandThread = std::thread(&GoodixDaemon::commandLoop, this);
+}
+
+GoodixDaemon::~GoodixDaemon() {
+    {
+        std::lock_guard<std::mutex> lock(mCommandLock);
+        mCommandExit = true;
+    }
+    mCommandCond.notify_one();
+    mCommandThread.join();
+
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+        mExit = true;
+    }
+    mCond.notify_one();
+    mThread.join();
+
+    if (mDaemon != nullptr) {
+        mDaemon->unlinkToDeath(mDeathRecipient);
+    }
+}
+
+sp<IGoodixFingerprintDaemon> GoodixDaemon::get() {
+    std::lock_guard<std::mutex> lock(mLock);
+    return mDaemon;
+}
+
+bool GoodixDaemon::sendCommand(int32_t cmd) {
+    sp<IGoodixFingerprintDaemon> daemon = get();
+    hidl_vec<int8_t> data;
+
+    if (daemon == nullptr) {
+        mDropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    int64_t startNs = monotonicNs();
+    Return<void> ret = daemon->sendCommand(cmd, data, [](int32_t, const hidl_vec<int8_t>&) {});
+    mCommandLatency.record(monotonicNs() - startNs);
+    if (!ret.isOk()) {
+        LOG(ERROR) << "sendCommand(" << cmd << ") error: " << ret.description();
+        mDropped.fetch_add(1, std::memory_order_relaxed);
+        if (ret.isDeadObject()) {
+            // Do not wait for the death notification to start looking again.
+            std::unique_lock<std::mutex> lock(mLock);
+            if (mDaemon.get() == daemon.get()) {
+                uint64_t generation = mGeneration;
+                lock.unlock();
+                disconnect(generation);
+            }
+        }
+        return false;
+    }
+    return true;
+}
+
+void GoodixDaemon::post(int32_t cmd, std::function<void()> onSent) {
+    {
+        std::lock_guard<std::mutex> lock(mCommandLock);
+        mCommands.push_back({cmd, monotonicNs(), std::move(onSent)});
+    }
+    mCommandCond.notify_one();
+}
+
+void GoodixDaemon::resetStats() {
+    mCommandLatency.reset();
+    mQueueDelay.reset();
+}
+
+std::string GoodixDaemon::dump() const {
+    std::string out;
+
+    StringAppendF(&out, "goodix daemon: dropped commands=%llu reconnects=%llu\n",
+                  static_cast<unsigned long long>(droppedCommands()),
+                  static_cast<unsigned long long>(reconnects()));
+    out += mCommandLatency.dump("daemon command");
+    out += mQueueDelay.dump("daemon command queue delay");
+    return out;
+}
+
+void GoodixDaemon::disconnect(uint64_t generation) {
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+        if (generation != mGeneration || mDaemon == nullptr) {
+            return;
+        }
+        mDaemon.clear();
+    }
+    mCond.notify_one();
+}
+
+void GoodixDaemon::threadLoop() {
+    auto retry = kRetryMin;
+
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mLock);
+            mCond.wait(lock, [&] { return mExit || mDaemon == nullptr; });
+            if (mExit) {
+                return;
+            }
+        }
+
+        // Looked up without the lock, this may take a while.
+        sp<IGoodixFingerprintDaemon> daemon = mLookup();
+        if (daemon == nullptr) {
+            std::unique_lock<std::mutex> lock(mLock);
+            mCond.wait_for(lock, retry, [&] { return mExit; });
+            retry = std::min<std::chrono::milliseconds>(retry * 2, kRetryMax);
+            continue;
+        }
+
+        // Linked under the lock, so a death notification waits for mDaemon to be set.
+        std::unique_lock<std::mutex> lock(mLock);
+        mGeneration++;
+        if (!daemon->linkToDeath(mDeathRecipient, mGeneration)) {
+            // Most likely died already, look it up again.
+            LOG(ERROR) << "Failed to link to Goodix fingerprint daemon death";
+            mCond.wait_for(lock, retry, [&] { return mExit; });
+            continue;
+        }
+        mDaemon = daemon;
+        retry = kRetryMin;
+
+        if (mGeneration > 1) {
+            mReconnects.fetch_add(1, std::memory_order_relaxed);
+        }
+        LOG(INFO) << "Connected to Goodix fingerprint daemon";
+    }
+}
+
+void GoodixDaemon::commandLoop() {
+    for (;;) {
+        Command command;
+        {
+            std::unique_lock<std::mutex> lock(mCommandLock);
+            mCommandCond.wait(lock, [&] { return mCommandExit || !mCommands.empty(); });
+            if (mCommandExit) {
+                return;
+            }
+            command = std::move(mCommands.front());
+            mCommands.pop_front();
+        }
+
+        mQueueDelay.record(monotonicNs() - command.postedNs);
+        if (sendCommand(command.cmd) && command.onSent) {
+            command.onSent();
+        }
+    }
+}
+
+}  // namespace implementation
+}  // namespace V1_0
+}  // namespace inscreen
+}  // namespace fingerprint
+}  // namespace biometrics
+}  // namespace mokee
+}  // namespace vendor
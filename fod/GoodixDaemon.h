@@ -0,0 +1,133 @@
+/*
+ * Copyright (C) 2020 The MoKee Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef VENDOR_MOKEE_BIOMETRICS_FINGERPRINT_INSCREEN_V1_0_GOODIXDAEMON_H
+#define VENDOR_MOKEE_BIOMETRICS_FINGERPRINT_INSCREEN_V1_0_GOODIXDAEMON_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <meizu/LatencyHistogram.h>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include <vendor/goodix/hardware/biometrics/fingerprint/2.1/IGoodixFingerprintDaemon.h>
+
+namespace vendor {
+namespace mokee {
+namespace biometrics {
+namespace fingerprint {
+namespace inscreen {
+namespace V1_0 {
+namespace implementation {
+
+using ::android::sp;
+using ::android::hardware::hidl_death_recipient;
+using ::meizu::sm8150::LatencyHistogram;
+
+using ::vendor::goodix::hardware::biometrics::fingerprint::V2_1::IGoodixFingerprintDaemon;
+
+/*
+ * Handle to the Goodix fingerprint daemon that survives daemon restarts.
+ *
+ * The daemon is looked up on a background thread, both at startup and
+ * whenever it dies, so sendCommand() never waits for the service manager.
+ * Commands sent while no daemon is connected are dropped and counted.
+ *
+ * post() hands a command to a worker thread, which sends posted commands
+ * in order. The caller can then do other work while the daemon handles it.
+ *
+ * The daemon is found through IGoodixFingerprintDaemon::tryGetService(),
+ * unless another lookup is given, e.g. one returning an in-process daemon.
+ */
+class GoodixDaemon {
+  public:
+    using Lookup = std::function<sp<IGoodixFingerprintDaemon>()>;
+
+    explicit GoodixDaemon(Lookup lookup = nullptr);
+    ~GoodixDaemon();
+
+    // Returns false if the command was dropped or failed.
+    bool sendCommand(int32_t cmd);
+    // onSent, if set, runs on the worker once the daemon has the command.
+    void post(int32_t cmd, std::function<void()> onSent = nullptr);
+
+    uint64_t droppedCommands() const { return mDropped.load(std::memory_order_relaxed); }
+    uint64_t reconnects() const { return mReconnects.load(std::memory_order_relaxed); }
+
+    void resetStats();
+    std::string dump() const;
+
+  private:
+    class DeathRecipient : public hidl_death_recipient {
+      public:
+        explicit DeathRecipient(GoodixDaemon *daemon) : mDaemon(daemon) {}
+        void serviceDied(uint64_t cookie,
+                         const ::android::wp<::android::hidl::base::V1_0::IBase> &who) override;
+
+      private:
+        GoodixDaemon *mDaemon;
+    };
+
+    sp<IGoodixFingerprintDaemon> get();
+    // Forget the daemon, unless a newer connection already replaced it.
+    void disconnect(uint64_t generation);
+    void threadLoop();
+    void commandLoop();
+
+    const Lookup mLookup;
+
+    std::mutex mLock;
+    std::condition_variable mCond;
+    sp<IGoodixFingerprintDaemon> mDaemon;
+    // Bumped on every connection, passed as the death recipient cookie.
+    uint64_t mGeneration;
+    bool mExit;
+
+    sp<DeathRecipient> mDeathRecipient;
+
+    std::atomic<uint64_t> mDropped;
+    std::atomic<uint64_t> mReconnects;
+
+    // Binder round trip of each command, and how long posted ones waited.
+    LatencyHistogram mCommandLatency;
+    LatencyHistogram mQueueDelay;
+
+    struct Command {
+        int32_t cmd;
+        int64_t postedNs;
+        std::function<void()> onSent;
+    };
+
+    std::mutex mCommandLock;
+    std::condition_variable mCommandCond;
+    std::deque<Command> mCommands;
+    bool mCommandExit;
+
+    std::thread mThread;
+    std::thread mCommandThread;
+};
+
+}  // namespace implementation
+}  // namespace V1_0
+}  // namespace inscreen
+}  // namespace fingerprint
+}  // namespace biometrics
+}  // namespace mokee
+}  // namespace vendor
+
+#endif  // VENDOR_MOKEE_BIOMETRICS_FINGERPRINT_INSCREEN_V1_0_GOODIXDAEMON_H
@@ -0,0 +1,189 @@
+/*
+ * Copyright (C) 2020 The MoKee Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define ATRACE_TAG ATRACE_TAG_HAL
+
+#include "Timeline.h"
+
+#include <android-base/stringprintf.h>
+#include <cutils/trace.h>
+#include <meizu/LatencyHistogram.h>
+
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
+using ::android::base::StringAppendF;
+using ::meizu::sm8150::monotonicNs;
+
+namespace vendor {
+namespace mokee {
+namespace biometrics {
+namespace fingerprint {
+namespace inscreen {
+namespace V1_0 {
+namespace implementation {
+
+static constexpr const char* kStageNames[Timeline::kStageCount] = {
+        "press", "hbm on", "finger down sent", "captured", "release",
+};
+
+static constexpr const char* kUnlockSlice = "fod unlock";
+static constexpr const char* kCaptureSlice = "fod capture";
+
+static int64_t percentile(const std::vector<int64_t>& sorted, int p) {
+    size_t index = std::min(sorted.size() - 1, sorted.size() * p / 100);
+    return sorted[index];
+}
+
+Timeline::Timeline()
+    : mNext(0), mSession(0), mFirstSession(1), mUnlockSlice(0), mCaptureSlice(0) {
+    for (auto& event : mEvents) {
+        event.seq.store(0, std::memory_order_relaxed);
+        event.session.store(0, std::memory_order_relaxed);
+        event.stage.store(0, std::memory_order_relaxed);
+        event.ns.store(0, std::memory_order_relaxed);
+    }
+}
+
+uint32_t Timeline::begin() {
+    uint32_t session = mSession.fetch_add(1, std::memory_order_relaxed) + 1;
+
+    record(session, Stage::PRESS, monotonicNs());
+    trace(session, Stage::PRESS);
+    return session;
+}
+
+void Timeline::mark(uint32_t session, Stage stage) {
+    if (session == 0) {
+        return;
+    }
+
+    record(session, stage, monotonicNs());
+    trace(session, stage);
+}
+
+void Timeline::record(uint32_t session, Stage stage, int64_t ns) {
+    Event& event = mEvents[mNext.fetch_add(1, std::memory_order_relaxed) % kCapacity];
+    uint32_t seq = event.seq.load(std::memory_order_relaxed);
+
+    event.seq.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    event.session.store(session, std::memory_order_relaxed);
+    event.stage.store(static_cast<uint32_t>(stage), std::memory_order_relaxed);
+    event.ns.store(ns, std::memory_order_relaxed);
+    event.seq.store(seq + 2, std::memory_order_release);
+}
+
+void Timeline::trace(uint32_t session, Stage stage) {
+    switch (stage) {
+        case Stage::PRESS:
+            if (atrace_is_tag_enabled(ATRACE_TAG)) {
+                atrace_async_begin(ATRACE_TAG, kUnlockSlice, session);
+                atrace_async_begin(ATRACE_TAG, kCaptureSlice, session);
+                mUnlockSlice.store(session, std::memory_order_relaxed);
+                mCaptureSlice.store(session, std::memory_order_relaxed);
+            }
+            break;
+        case Stage::CAPTURED:
+            if (mCaptureSlice.exchange(0, std::memory_order_relaxed) == session) {
+                atrace_async_end(ATRACE_TAG, kCaptureSlice, session);
+            }
+            break;
+        case Stage::RELEASE:
+            // Capture never completed if its slice is still open.
+            if (mCaptureSlice.exchange(0, std::memory_order_relaxed) == session) {
+                atrace_async_end(ATRACE_TAG, kCaptureSlice, session);
+            }
+            if (mUnlockSlice.exchange(0, std::memory_order_relaxed) == session) {
+                atrace_async_end(ATRACE_TAG, kUnlockSlice, session);
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+void Timeline::reset() {
+    mFirstSession.store(current() + 1, std::memory_order_relaxed);
+}
+
+std::string Timeline::dump() const {
+    struct Stamp {
+        uint32_t session;
+        uint32_t stage;
+        int64_t ns;
+    };
+
+    uint32_t firstSession = mFirstSession.load(std::memory_order_relaxed);
+    std::vector<Stamp> stamps;
+    std::unordered_map<uint32_t, int64_t> pressNs;
+
+    stamps.reserve(kCapacity);
+    for (const auto& event : mEvents) {
+        uint32_t seq = event.seq.load(std::memory_order_acquire);
+        if (seq == 0 || (seq & 1) != 0) {
+            continue;
+        }
+
+        Stamp stamp = {event.session.load(std::memory_order_relaxed),
+                       event.stage.load(std::memory_order_relaxed),
+                       event.ns.load(std::memory_order_relaxed)};
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (event.seq.load(std::memory_order_relaxed) != seq || stamp.session < firstSession ||
+            stamp.stage >= kStageCount) {
+            continue;
+        }
+
+        if (stamp.stage == static_cast<uint32_t>(Stage::PRESS)) {
+            pressNs[stamp.session] = stamp.ns;
+        } else {
+            stamps.push_back(stamp);
+        }
+    }
+
+    std::array<std::vector<int64_t>, kStageCount> deltas;
+    for (const auto& stamp : stamps) {
+        auto press = pressNs.find(stamp.session);
+        if (press != pressNs.end()) {
+            deltas[stamp.stage].push_back(stamp.ns - press->second);
+        }
+    }
+
+    std::string out;
+    StringAppendF(&out, "unlock timeline: sessions=%zu\n", pressNs.size());
+    for (size_t i = 1; i < kStageCount; i++) {
+        std::vector<int64_t>& v = deltas[i];
+        if (v.empty()) {
+            StringAppendF(&out, "    press -> %s: count=0\n", kStageNames[i]);
+            continue;
+        }
+
+        std::sort(v.begin(), v.end());
+        StringAppendF(&out, "    press -> %s: count=%zu p50=%.1fus p95=%.1fus p99=%.1fus\n",
+                      kStageNames[i], v.size(), percentile(v, 50) / 1000.0,
+                      percentile(v, 95) / 1000.0, percentile(v, 99) / 1000.0);
+    }
+    return out;
+}
+
+}  // namespace implementation
+}  // namespace V1_0
+}  // namespace inscreen
+}  // namespace fingerprint
+}  // namespace biometrics
+}  // namespace mokee
+}  // namespace vendor
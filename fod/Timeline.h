@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2020 The MoKee Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef VENDOR_MOKEE_BIOMETRICS_FINGERPRINT_INSCREEN_V1_0_TIMELINE_H
+#define VENDOR_MOKEE_BIOMETRICS_FINGERPRINT_INSCREEN_V1_0_TIMELINE_H
+
+#include <array>
+#include <atomic>
+#include <string>
+
+namespace vendor {
+namespace mokee {
+namespace biometrics {
+namespace fingerprint {
+namespace inscreen {
+namespace V1_0 {
+namespace implementation {
+
+/*
+ * Records when each stage of an unlock attempt was reached.
+ *
+ * Every finger down starts a session, and stages are stamped with the
+ * monotonic clock into a fixed-size ring that any thread may write to
+ * without locking. The dump reports percentiles of the time from finger
+ * down to each stage over the sessions still in the ring.
+ *
+ * Each session is also traced as "fod unlock" (finger down to up) and
+ * "fod capture" (finger down to image captured) atrace async slices.
+ */
+class Timeline {
+  public:
+    enum class Stage {
+        PRESS,
+        HBM_ON,
+        FINGER_DOWN_SENT,
+        CAPTURED,
+        RELEASE,
+        COUNT,
+    };
+
+    static constexpr size_t kStageCount = static_cast<size_t>(Stage::COUNT);
+    static constexpr size_t kCapacity = 512;
+
+    Timeline();
+
+    // Starts a session at Stage::PRESS and returns its id.
+    uint32_t begin();
+    void mark(uint32_t session, Stage stage);
+    uint32_t current() const { return mSession.load(std::memory_order_relaxed); }
+
+    // Forget the sessions recorded so far.
+    void reset();
+    std::string dump() const;
+
+  private:
+    // A slot is being written while its sequence number is odd.
+    struct Event {
+        std::atomic<uint32_t> seq;
+        std::atomic<uint32_t> session;
+        std::atomic<uint32_t> stage;
+        std::atomic<int64_t> ns;
+    };
+
+    void record(uint32_t session, Stage stage, int64_t ns);
+    void trace(uint32_t session, Stage stage);
+
+    std::array<Event, kCapacity> mEvents;
+    std::atomic<uint64_t> mNext;
+    std::atomic<uint32_t> mSession;
+    std::atomic<uint32_t> mFirstSession;
+
+    // Sessions with an async slice still open, 0 for none.
+    std::atomic<uint32_t> mUnlockSlice;
+    std::atomic<uint32_t> mCaptureSlice;
+};
+
+}  // namespace implementation
+}  // namespace V1_0
+}  // namespace inscreen
+}  // namespace fingerprint
+}  // namespace biometrics
+}  // namespace mokee
+}  // namespace vendor
+
+#endif  // VENDOR_MOKEE_BIOMETRICS_FINGERPRINT_INSCREEN_V1_0_TIMELINE_H
@@ -18,10 +18,12 @@
 #define LOG_TAG "mokee.biometrics.fingerprint.inscreen@1.0-service.meizu_sm8150"
 
 #include <android-base/logging.h>
+#include <android-base/properties.h>
 #include <hidl/HidlTransportSupport.h>
 
 #include "FingerprintInscreen.h"
 
+using android::base::GetUintProperty;
 using android::hardware::configureRpcThreadpool;
 using android::hardware::joinRpcThreadpool;
 
@@ -32,7 +34,11 @@ using android::OK;
 using android::status_t;
 
 int main() {
-    android::sp<IFingerprintInscreen> service = new FingerprintInscreen();
+    FingerprintInscreen::Config config;
+    config.boostTimeoutMs = GetUintProperty<uint32_t>("ro.vendor.fod.boost_timeout_ms",
+                                                      config.boostTimeoutMs);
+
+    android::sp<IFingerprintInscreen> service = new FingerprintInscreen(config);
 
     configureRpcThreadpool(1, true);
 
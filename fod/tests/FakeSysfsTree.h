@@ -0,0 +1,69 @@
+/*
+ * Copyright (C) 2020 The MoKee Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MEIZU_SM8150_FOD_TESTS_FAKESYSFSTREE_H
+#define MEIZU_SM8150_FOD_TESTS_FAKESYSFSTREE_H
+
+#include <meizu/ScratchSysfs.h>
+
+#include <string>
+
+#include "FingerprintInscreen.h"
+#include "MockGoodixDaemon.h"
+
+namespace vendor {
+namespace mokee {
+namespace biometrics {
+namespace fingerprint {
+namespace inscreen {
+namespace V1_0 {
+namespace implementation {
+
+/*
+ * The HBM, brightness and QoS nodes in a scratch directory, for running
+ * FingerprintInscreen off-device through Config::sysfsRoot.
+ */
+class FakeSysfsTree : public ::meizu::sm8150::ScratchSysfs {
+  public:
+    static constexpr const char* kHbm = "/sys/class/meizu/lcm/display/hbm";
+    static constexpr const char* kBrightness =
+            "/sys/class/backlight/panel0-backlight/actual_brightness";
+    static constexpr const char* kQos = "/sys/class/meizu/fp/qos_set";
+
+    explicit FakeSysfsTree(int brightness = 512) {
+        create(kHbm, "0");
+        create(kBrightness, std::to_string(brightness));
+        create(kQos, "0");
+    }
+
+    FingerprintInscreen::Config config(const sp<MockGoodixDaemon>& daemon) const {
+        FingerprintInscreen::Config config;
+
+        config.sysfsRoot = root();
+        config.daemonLookup = [daemon] { return sp<IGoodixFingerprintDaemon>(daemon); };
+        return config;
+    }
+};
+
+}  // namespace implementation
+}  // namespace V1_0
+}  // namespace inscreen
+}  // namespace fingerprint
+}  // namespace biometrics
+}  // namespace mokee
+}  // namespace vendor
+
+#endif  // MEIZU_SM8150_FOD_TESTS_FAKESYSFSTREE_H
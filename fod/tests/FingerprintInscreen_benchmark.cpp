@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2020 The MoKee Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+#include <meizu/LatencyHistogram.h>
+
+#include <string>
+
+#include "FakeSysfsTree.h"
+
+using android::sp;
+using meizu::sm8150::LatencyHistogram;
+using meizu::sm8150::monotonicNs;
+using vendor::mokee::biometrics::fingerprint::inscreen::V1_0::implementation::FakeSysfsTree;
+using vendor::mokee::biometrics::fingerprint::inscreen::V1_0::implementation::FingerprintInscreen;
+using vendor::mokee::biometrics::fingerprint::inscreen::V1_0::implementation::MockGoodixDaemon;
+
+namespace {
+
+void reportTail(benchmark::State& state, const std::string& stage,
+                const LatencyHistogram& latency) {
+    state.counters[stage + "_p50_us"] = latency.percentileNs(50) / 1000.0;
+    state.counters[stage + "_p99_us"] = latency.percentileNs(99) / 1000.0;
+}
+
+/*
+ * Time spent in each of two HAL calls, as seen by the binder thread, for a
+ * daemon taking the given time per command. Commands are only posted, so
+ * a slow daemon should not show up here. Between iterations the daemon is
+ * given time to catch up, so that its queue does not grow without bound.
+ */
+template <typename First, typename Second>
+void runPair(benchmark::State& state, const std::string& firstName, First first,
+             const std::string& secondName, Second second) {
+    FakeSysfsTree tree;
+    sp<MockGoodixDaemon> daemon = new MockGoodixDaemon();
+    sp<FingerprintInscreen> hal = new FingerprintInscreen(tree.config(daemon));
+    LatencyHistogram firstLatency;
+    LatencyHistogram secondLatency;
+
+    if (!daemon->waitForConnection(1000)) {
+        state.SkipWithError("Goodix daemon mock never connected");
+        return;
+    }
+    daemon->setLatencyUs(state.range(0));
+
+    for (auto _ : state) {
+        int64_t startNs = monotonicNs();
+        first(hal);
+        int64_t firstNs = monotonicNs();
+        second(hal);
+        int64_t secondNs = monotonicNs();
+
+        firstLatency.record(firstNs - startNs);
+        secondLatency.record(secondNs - firstNs);
+
+        state.PauseTiming();
+        daemon->waitForCommands(2, 1000);
+        daemon->clear();
+        state.ResumeTiming();
+    }
+
+    state.SetItemsProcessed(state.iterations());
+    reportTail(state, firstName, firstLatency);
+    reportTail(state, secondName, secondLatency);
+}
+
+void BM_pressRelease(benchmark::State& state) {
+    runPair(
+            state, "press", [](const sp<FingerprintInscreen>& hal) { hal->onPress(); },
+            "release", [](const sp<FingerprintInscreen>& hal) { hal->onRelease(); });
+}
+
+BENCHMARK(BM_pressRelease)->ArgName("daemon_us")->Arg(0)->Arg(500)->UseRealTime();
+
+void BM_showHide(benchmark::State& state) {
+    runPair(
+            state, "show", [](const sp<FingerprintInscreen>& hal) { hal->onShowFODView(); },
+            "hide", [](const sp<FingerprintInscreen>& hal) { hal->onHideFODView(); });
+}
+
+BENCHMARK(BM_showHide)->ArgName("daemon_us")->Arg(0)->Arg(500)->UseRealTime();
+
+}  // anonymous namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,130 @@
+/*
+ * Copyright (C) 2020 The MoKee Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <vector>
+
+#include "FakeSysfsTree.h"
+
+using android::sp;
+using vendor::mokee::biometrics::fingerprint::inscreen::V1_0::implementation::FakeSysfsTree;
+using vendor::mokee::biometrics::fingerprint::inscreen::V1_0::implementation::FingerprintInscreen;
+using vendor::mokee::biometrics::fingerprint::inscreen::V1_0::implementation::MockGoodixDaemon;
+
+namespace {
+
+// Goodix daemon commands, as sent by the HAL.
+constexpr int32_t kFingerDown = 1536;
+constexpr int32_t kFingerUp = 1537;
+constexpr int32_t kUiReady = 1607;
+constexpr int32_t kUiDisappear = 1608;
+
+constexpr int32_t kAcquiredGood = 0;
+
+class FingerprintInscreenTest : public ::testing::Test {
+  protected:
+    void SetUp() override {
+        mDaemon = new MockGoodixDaemon();
+        mHal = new FingerprintInscreen(mTree.config(mDaemon));
+        // Commands posted before the daemon connects are dropped.
+        ASSERT_TRUE(mDaemon->waitForConnection(1000));
+    }
+
+    // The ids of the first count commands, once that many have arrived.
+    std::vector<int32_t> commands(size_t count) {
+        std::vector<int32_t> ids;
+
+        EXPECT_TRUE(mDaemon->waitForCommands(count, 1000));
+        for (const auto& command : mDaemon->commands()) {
+            ids.push_back(command.cmd);
+        }
+        return ids;
+    }
+
+    FakeSysfsTree mTree;
+    sp<MockGoodixDaemon> mDaemon;
+    sp<FingerprintInscreen> mHal;
+};
+
+TEST_F(FingerprintInscreenTest, PressTurnsOnHbmAndPostsFingerDown) {
+    mHal->onPress();
+
+    EXPECT_EQ("1", mTree.read(FakeSysfsTree::kHbm));
+    EXPECT_EQ("1", mTree.read(FakeSysfsTree::kQos));
+    EXPECT_EQ(std::vector<int32_t>({kFingerDown}), commands(1));
+}
+
+TEST_F(FingerprintInscreenTest, ReleaseDropsHbmAndPostsFingerUp) {
+    mHal->onPress();
+    mHal->onRelease();
+
+    EXPECT_EQ("0", mTree.read(FakeSysfsTree::kHbm));
+    EXPECT_EQ("0", mTree.read(FakeSysfsTree::kQos));
+    EXPECT_EQ(std::vector<int32_t>({kFingerDown, kFingerUp}), commands(2));
+}
+
+TEST_F(FingerprintInscreenTest, AcquiredGoodKeepsHbmUntilRelease) {
+    mHal->onPress();
+    mHal->handleAcquired(kAcquiredGood, 0);
+
+    EXPECT_EQ("1", mTree.read(FakeSysfsTree::kHbm));
+    EXPECT_EQ("1", mTree.read(FakeSysfsTree::kQos));
+
+    mHal->onRelease();
+    EXPECT_EQ("0", mTree.read(FakeSysfsTree::kHbm));
+}
+
+TEST_F(FingerprintInscreenTest, ShowAndHidePostUiCommandsInOrder) {
+    mHal->onShowFODView();
+    EXPECT_EQ("1", mTree.read(FakeSysfsTree::kQos));
+
+    mHal->onHideFODView();
+    EXPECT_EQ("0", mTree.read(FakeSysfsTree::kQos));
+    EXPECT_EQ(std::vector<int32_t>({kUiReady, kUiDisappear}), commands(2));
+}
+
+TEST_F(FingerprintInscreenTest, SlowDaemonDoesNotHoldUpPress) {
+    mDaemon->setLatencyUs(100000);
+
+    auto start = std::chrono::steady_clock::now();
+    mHal->onPress();
+    mHal->onRelease();
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    EXPECT_LT(elapsed, std::chrono::milliseconds(50));
+    // Still sent in order, one after the other.
+    EXPECT_EQ(std::vector<int32_t>({kFingerDown, kFingerUp}), commands(2));
+}
+
+TEST_F(FingerprintInscreenTest, DoesNotRegisterForDaemonMessages) {
+    mHal->onPress();
+    commands(1);
+
+    // setNotify() would replace the vendor fingerprint HAL's callback.
+    EXPECT_FALSE(mDaemon->sendMessage(kFingerDown, 0));
+}
+
+TEST_F(FingerprintInscreenTest, DimAmountFollowsBrightness) {
+    mTree.write(FakeSysfsTree::kBrightness, "0");
+    EXPECT_EQ(255, mHal->getDimAmount(0));
+
+    mTree.write(FakeSysfsTree::kBrightness, "1023");
+    EXPECT_EQ(0, mHal->getDimAmount(0));
+}
+
+}  // anonymous namespace
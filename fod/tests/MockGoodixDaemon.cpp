@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2020 The MoKee Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <meizu/LatencyHistogram.h>
+#include <unistd.h>
+
+#include <chrono>
+
+#include "MockGoodixDaemon.h"
+
+namespace vendor {
+namespace mokee {
+namespace biometrics {
+namespace fingerprint {
+namespace inscreen {
+namespace V1_0 {
+namespace implementation {
+
+using ::android::hardware::Void;
+using ::meizu::sm8150::monotonicNs;
+
+MockGoodixDaemon::MockGoodixDaemon() : mLatencyUs(0), mResult(0), mConnected(false) {}
+
+Return<void> MockGoodixDaemon::setNotify(const sp<IGoodixFingerprintDaemonCallback>& callback) {
+    std::lock_guard<std::mutex> lock(mLock);
+    mCallback = callback;
+    return Void();
+}
+
+Return<void> MockGoodixDaemon::sendCommand(int32_t cmd, const hidl_vec<int8_t>&,
+                                           sendCommand_cb hidl_cb) {
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+        mCommands.push_back({cmd, monotonicNs()});
+    }
+    mCond.notify_all();
+
+    // Recorded first, so that a command shows up while it is still blocked.
+    uint32_t latencyUs = mLatencyUs.load();
+    if (latencyUs > 0) {
+        usleep(latencyUs);
+    }
+
+    hidl_cb(mResult.load(), hidl_vec<int8_t>());
+    return Void();
+}
+
+Return<bool> MockGoodixDaemon::linkToDeath(const sp<hidl_death_recipient>& recipient,
+                                           uint64_t) {
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+        mConnected = true;
+    }
+    mCond.notify_all();
+    return recipient != nullptr;
+}
+
+std::vector<MockGoodixDaemon::Command> MockGoodixDaemon::commands() const {
+    std::lock_guard<std::mutex> lock(mLock);
+    return mCommands;
+}
+
+void MockGoodixDaemon::clear() {
+    std::lock_guard<std::mutex> lock(mLock);
+    mCommands.clear();
+}
+
+bool MockGoodixDaemon::waitForCommands(size_t count, uint32_t timeoutMs) const {
+    std::unique_lock<std::mutex> lock(mLock);
+    return mCond.wait_for(lock, std::chrono::milliseconds(timeoutMs),
+                          [&] { return mCommands.size() >= count; });
+}
+
+bool MockGoodixDaemon::waitForConnection(uint32_t timeoutMs) const {
+    std::unique_lock<std::mutex> lock(mLock);
+    return mCond.wait_for(lock, std::chrono::milliseconds(timeoutMs), [&] { return mConnected; });
+}
+
+bool MockGoodixDaemon::sendMessage(int32_t msgId, int32_t cmdId) {
+    sp<IGoodixFingerprintDaemonCallback> callback;
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+        callback = mCallback;
+    }
+
+    if (callback == nullptr) {
+        return false;
+    }
+    return callback->onDaemonMessage(0, msgId, cmdId, hidl_vec<int8_t>()).isOk();
+}
+
+}  // namespace implementation
+}  // namespace V1_0
+}  // namespace inscreen
+}  // namespace fingerprint
+}  // namespace biometrics
+}  // namespace mokee
+}  // namespace vendor
@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2020 The MoKee Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MEIZU_SM8150_FOD_TESTS_MOCKGOODIXDAEMON_H
+#define MEIZU_SM8150_FOD_TESTS_MOCKGOODIXDAEMON_H
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+#include <vendor/goodix/hardware/biometrics/fingerprint/2.1/IGoodixFingerprintDaemon.h>
+
+namespace vendor {
+namespace mokee {
+namespace biometrics {
+namespace fingerprint {
+namespace inscreen {
+namespace V1_0 {
+namespace implementation {
+
+using ::android::sp;
+using ::android::hardware::hidl_death_recipient;
+using ::android::hardware::hidl_vec;
+using ::android::hardware::Return;
+
+using ::vendor::goodix::hardware::biometrics::fingerprint::V2_1::IGoodixFingerprintDaemon;
+using ::vendor::goodix::hardware::biometrics::fingerprint::V2_1::IGoodixFingerprintDaemonCallback;
+
+/*
+ * An in-process IGoodixFingerprintDaemon, for running the HAL off-device
+ * through FingerprintInscreen::Config::daemonLookup.
+ *
+ * Every command is recorded with a timestamp. Each can be made to take a
+ * fixed time and to return a result code, to stand in for a slow or
+ * failing daemon. Daemon messages can be delivered to whatever callback
+ * was registered with setNotify(). Every method may be called from any
+ * thread.
+ */
+class MockGoodixDaemon : public IGoodixFingerprintDaemon {
+  public:
+    struct Command {
+        int32_t cmd;
+        // monotonicNs() when the command arrived.
+        int64_t timeNs;
+    };
+
+    MockGoodixDaemon();
+
+    Return<void> setNotify(const sp<IGoodixFingerprintDaemonCallback>& callback) override;
+    Return<void> sendCommand(int32_t cmd, const hidl_vec<int8_t>& data,
+                             sendCommand_cb hidl_cb) override;
+    Return<bool> linkToDeath(const sp<hidl_death_recipient>& recipient, uint64_t cookie) override;
+
+    // How long each command blocks before returning.
+    void setLatencyUs(uint32_t latencyUs) { mLatencyUs.store(latencyUs); }
+    // The result code of each command.
+    void setResult(int32_t result) { mResult.store(result); }
+
+    std::vector<Command> commands() const;
+    void clear();
+
+    // Returns false if fewer than count commands arrived within timeoutMs.
+    // A command counts as soon as it arrives, before its latency has passed.
+    bool waitForCommands(size_t count, uint32_t timeoutMs) const;
+    // Returns false if no GoodixDaemon connected within timeoutMs.
+    bool waitForConnection(uint32_t timeoutMs) const;
+
+    // Delivers a message to the setNotify() callback. Returns false if none is registered.
+    bool sendMessage(int32_t msgId, int32_t cmdId);
+
+  private:
+    std::atomic<uint32_t> mLatencyUs;
+    std::atomic<int32_t> mResult;
+
+    mutable std::mutex mLock;
+    mutable std::condition_variable mCond;
+    std::vector<Command> mCommands;
+    sp<IGoodixFingerprintDaemonCallback> mCallback;
+    bool mConnected;
+};
+
+}  // namespace implementation
+}  // namespace V1_0
+}  // namespace inscreen
+}  // namespace fingerprint
+}  // namespace biometrics
+}  // namespace mokee
+}  // namespace vendor
+
+#endif  // MEIZU_SM8150_FOD_TESTS_MOCKGOODIXDAEMON_H
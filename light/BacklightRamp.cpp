@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2020 The MoKee Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "LightService"
+
+#include "BacklightRamp.h"
+
+#include <meizu/LatencyHistogram.h>
+
+using meizu::sm8150::monotonicNs;
+
+namespace android {
+namespace hardware {
+namespace light {
+namespace V2_0 {
+namespace implementation {
+
+BacklightRamp::BacklightRamp(uint32_t periodUs, StepCallback onStep)
+    : mPeriodUs(periodUs > 0 ? periodUs : 1),
+      mOnStep(onStep),
+      mActive(false),
+      mFrom(0),
+      mTo(0),
+      mStartNs(0),
+      mDurationNs(0),
+      mNextStepNs(0),
+      mThread("backlight ramp", [this] { return step(); }) {}
+
+BacklightRamp::~BacklightRamp() {
+    mThread.stop();
+}
+
+void BacklightRamp::start(float from, float to, uint32_t durationMs) {
+    if (!mThread.valid() || durationMs == 0) {
+        cancel();
+        mOnStep(to);
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mLock);
+
+    mFrom = from;
+    mTo = to;
+    mStartNs = monotonicNs();
+    mDurationNs = durationMs * 1000000LL;
+    mNextStepNs = mStartNs + mPeriodUs * 1000LL;
+    mActive.store(true);
+
+    mThread.wake();
+}
+
+void BacklightRamp::cancel() {
+    if (!mActive.load()) {
+        return;
+    }
+
+    // A step already waiting for the lock sees the ramp inactive and stops the timer.
+    std::lock_guard<std::mutex> lock(mLock);
+    mActive.store(false);
+}
+
+/*
+ * Returns when the next step is due, or 0 once the ramp is over.
+ */
+int64_t BacklightRamp::step() {
+    std::lock_guard<std::mutex> lock(mLock);
+
+    if (!mActive.load()) {
+        return 0;
+    }
+
+    int64_t now = monotonicNs();
+    if (now < mNextStepNs) {
+        return mNextStepNs;
+    }
+
+    int64_t elapsed = now - mStartNs;
+    float progress = elapsed >= mDurationNs ? 1.0f : elapsed / static_cast<float>(mDurationNs);
+
+    mOnStep(mFrom + (mTo - mFrom) * progress);
+
+    if (progress >= 1.0f) {
+        mActive.store(false);
+        return 0;
+    }
+
+    mNextStepNs = now + mPeriodUs * 1000LL;
+    return mNextStepNs;
+}
+
+}  // namespace implementation
+}  // namespace V2_0
+}  // namespace light
+}  // namespace hardware
+}  // namespace android
@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2020 The MoKee Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANDROID_HARDWARE_LIGHT_V2_0_BACKLIGHTRAMP_H
+#define ANDROID_HARDWARE_LIGHT_V2_0_BACKLIGHTRAMP_H
+
+#include <meizu/TimerThread.h>
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+
+namespace android {
+namespace hardware {
+namespace light {
+namespace V2_0 {
+namespace implementation {
+
+using ::meizu::sm8150::TimerThread;
+
+/*
+ * Fades the backlight between two levels on its own thread.
+ *
+ * A timer wakes the thread once per step, typically once per panel
+ * refresh, and the interpolated level is handed to the step
+ * callback. Once cancel() returns, the callback will not be invoked
+ * again until the next start().
+ */
+class BacklightRamp {
+  public:
+    using StepCallback = std::function<void(float level)>;
+
+    BacklightRamp(uint32_t periodUs, StepCallback onStep);
+    ~BacklightRamp();
+
+    void start(float from, float to, uint32_t durationMs);
+    void cancel();
+
+  private:
+    int64_t step();
+
+    uint32_t mPeriodUs;
+    StepCallback mOnStep;
+
+    // Guards the ramp parameters and serializes steps against cancel().
+    std::mutex mLock;
+    std::atomic<bool> mActive;
+    float mFrom;
+    float mTo;
+    int64_t mStartNs;
+    int64_t mDurationNs;
+    int64_t mNextStepNs;
+
+    TimerThread mThread;
+};
+
+}  // namespace implementation
+}  // namespace V2_0
+}  // namespace light
+}  // namespace hardware
+}  // namespace android
+
+#endif  // ANDROID_HARDWARE_LIGHT_V2_0_BACKLIGHTRAMP_H
@@ -0,0 +1,75 @@
+/*
+ * Copyright (C) 2020 The MoKee Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "BacklightWriter.h"
+
+using meizu::sm8150::monotonicNs;
+
+namespace android {
+namespace hardware {
+namespace light {
+namespace V2_0 {
+namespace implementation {
+
+BacklightWriter::BacklightWriter(SysfsNode& node)
+    : mNode(node), mPending(kNoValue), mCoalesced(0), mExit(false) {
+    mThread = std::thread(&BacklightWriter::threadLoop, this);
+}
+
+BacklightWriter::~BacklightWriter() {
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+        mExit = true;
+    }
+    mCond.notify_one();
+    mThread.join();
+}
+
+void BacklightWriter::publish(uint32_t brightness) {
+    if (mPending.exchange(brightness) != kNoValue) {
+        // The writer has not picked up the previous level yet.
+        mCoalesced.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    // Taking the lock orders this wakeup against the writer's predicate check.
+    { std::lock_guard<std::mutex> lock(mLock); }
+    mCond.notify_one();
+}
+
+void BacklightWriter::threadLoop() {
+    for (;;) {
+        int64_t brightness = mPending.exchange(kNoValue);
+        if (brightness != kNoValue) {
+            int64_t start = monotonicNs();
+            mNode.write(brightness);
+            mWriteLatency.record(monotonicNs() - start);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(mLock);
+        mCond.wait(lock, [this] { return mExit || mPending.load() != kNoValue; });
+        if (mExit) {
+            return;
+        }
+    }
+}
+
+}  // namespace implementation
+}  // namespace V2_0
+}  // namespace light
+}  // namespace hardware
+}  // namespace android
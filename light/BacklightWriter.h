@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2020 The MoKee Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANDROID_HARDWARE_LIGHT_V2_0_BACKLIGHTWRITER_H
+#define ANDROID_HARDWARE_LIGHT_V2_0_BACKLIGHTWRITER_H
+
+#include <meizu/LatencyHistogram.h>
+#include <meizu/SysfsNode.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace android {
+namespace hardware {
+namespace light {
+namespace V2_0 {
+namespace implementation {
+
+using ::meizu::sm8150::LatencyHistogram;
+using ::meizu::sm8150::SysfsNode;
+
+/*
+ * Writes backlight levels on a dedicated thread.
+ *
+ * Callers publish the target level into a single slot and return
+ * immediately. The writer thread always takes the newest value, so
+ * levels published while a write is in flight replace each other and
+ * only the last one reaches sysfs.
+ */
+class BacklightWriter {
+  public:
+    explicit BacklightWriter(SysfsNode& node);
+    ~BacklightWriter();
+
+    void publish(uint32_t brightness);
+
+    // Number of published levels that were replaced before being written.
+    uint64_t coalescedWrites() const { return mCoalesced.load(std::memory_order_relaxed); }
+
+    // Time spent in each sysfs write on the writer thread.
+    const LatencyHistogram& writeLatency() const { return mWriteLatency; }
+
+  private:
+    static constexpr int64_t kNoValue = -1;
+
+    void threadLoop();
+
+    SysfsNode& mNode;
+
+    std::atomic<int64_t> mPending;
+    std::atomic<uint64_t> mCoalesced;
+    LatencyHistogram mWriteLatency;
+
+    std::mutex mLock;
+    std::condition_variable mCond;
+    bool mExit;
+
+    std::thread mThread;
+};
+
+}  // namespace implementation
+}  // namespace V2_0
+}  // namespace light
+}  // namespace hardware
+}  // namespace android
+
+#endif  // ANDROID_HARDWARE_LIGHT_V2_0_BACKLIGHTWRITER_H
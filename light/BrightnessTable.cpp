@@ -0,0 +1,51 @@
+/*
+ * Copyright (C) 2020 The MoKee Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "BrightnessTable.h"
+
+#include <cmath>
+
+namespace android {
+namespace hardware {
+namespace light {
+namespace V2_0 {
+namespace implementation {
+
+void buildBrightnessTable(BrightnessTable& table, int maxBrightness, float gamma) {
+    const uint32_t maxLevel = table.size() - 1;
+    bool linear = !(gamma > 0.0f) || gamma == 1.0f;
+
+    for (size_t i = 0; i < table.size(); i++) {
+        if (linear) {
+            table[i] = i * maxBrightness / maxLevel;
+            continue;
+        }
+
+        float level = std::pow(i / static_cast<float>(maxLevel), gamma);
+        table[i] = std::lround(level * maxBrightness);
+
+        // Never turn the panel off for a non-zero request.
+        if (i > 0 && table[i] == 0) {
+            table[i] = 1;
+        }
+    }
+}
+
+}  // namespace implementation
+}  // namespace V2_0
+}  // namespace light
+}  // namespace hardware
+}  // namespace android
@@ -0,0 +1,46 @@
+/*
+ * Copyright (C) 2020 The MoKee Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANDROID_HARDWARE_LIGHT_V2_0_BRIGHTNESSTABLE_H
+#define ANDROID_HARDWARE_LIGHT_V2_0_BRIGHTNESSTABLE_H
+
+#include <stdint.h>
+
+#include <array>
+
+namespace android {
+namespace hardware {
+namespace light {
+namespace V2_0 {
+namespace implementation {
+
+// Maps framework brightness (0-255) to panel brightness.
+using BrightnessTable = std::array<uint32_t, 256>;
+
+/*
+ * Build the framework to panel brightness table. Without a gamma (or with
+ * a gamma of 1) this is the linear scaling across the accepted range. On a
+ * curve, non-zero levels never map to 0.
+ */
+void buildBrightnessTable(BrightnessTable& table, int maxBrightness, float gamma);
+
+}  // namespace implementation
+}  // namespace V2_0
+}  // namespace light
+}  // namespace hardware
+}  // namespace android
+
+#endif  // ANDROID_HARDWARE_LIGHT_V2_0_BRIGHTNESSTABLE_H
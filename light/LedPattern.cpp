@@ -0,0 +1,184 @@
+/*
+ * Copyright (C) 2020 The MoKee Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "LightService"
+
+#include "LedPattern.h"
+
+#include <android-base/file.h>
+#include <android-base/logging.h>
+#include <android-base/parseint.h>
+#include <android-base/strings.h>
+
+using android::base::ParseInt;
+using android::base::ReadFileToString;
+using android::base::Split;
+using android::base::Trim;
+using android::base::WriteStringToFile;
+
+namespace android {
+namespace hardware {
+namespace light {
+namespace V2_0 {
+namespace implementation {
+
+static constexpr int DEFAULT_LED_MAX_BRIGHTNESS = 255;
+
+static bool hasTrigger(const std::string& ledPath, const std::string& trigger) {
+    std::string triggers;
+
+    if (!ReadFileToString(ledPath + "/trigger", &triggers)) {
+        return false;
+    }
+
+    // The active trigger is reported in brackets, e.g. "none [timer] ...".
+    for (auto& name : Split(Trim(triggers), " ")) {
+        if (name == trigger || name == "[" + trigger + "]") {
+            return true;
+        }
+    }
+    return false;
+}
+
+LedPattern::LedPattern(const std::string& ledPath)
+    : mLedPath(ledPath),
+      mHardwareTimer(hasTrigger(ledPath, "timer")),
+      mActive(false),
+      mOnMs(0),
+      mOffMs(0),
+      mBrightness(ledPath + "/brightness"),
+      mMaxBrightness(DEFAULT_LED_MAX_BRIGHTNESS),
+      mLit(false),
+      mNextEdgeNs(0) {
+    if (mHardwareTimer) {
+        LOG(INFO) << "Using timer trigger for LED patterns";
+        return;
+    }
+
+    std::string max;
+    if (ReadFileToString(ledPath + "/max_brightness", &max) &&
+        !ParseInt(Trim(max), &mMaxBrightness, 1)) {
+        LOG(ERROR) << "Invalid LED max brightness: " << max;
+        mMaxBrightness = DEFAULT_LED_MAX_BRIGHTNESS;
+    }
+
+    mThread = std::make_unique<TimerThread>("LED pattern scheduler", [this] { return step(); },
+                                            CLOCK_BOOTTIME_ALARM);
+    if (!mThread->valid()) {
+        LOG(ERROR) << "No LED pattern scheduler, timed patterns fall back to the driver";
+    }
+}
+
+LedPattern::~LedPattern() {
+    if (mThread) {
+        mThread->stop();
+    }
+}
+
+bool LedPattern::supported() const {
+    return mHardwareTimer || mThread->valid();
+}
+
+bool LedPattern::start(uint32_t onMs, uint32_t offMs) {
+    std::lock_guard<std::mutex> lock(mLock);
+
+    // Keep the phase of a pattern that is already running.
+    if (mActive && mOnMs == onMs && mOffMs == offMs) {
+        return true;
+    }
+
+    if (mHardwareTimer) {
+        mActive = startHardware(onMs, offMs);
+    } else if (mThread->valid()) {
+        // A new pattern always begins with the on phase.
+        mLit = true;
+        mNextEdgeNs = mThread->now() + onMs * 1000000LL;
+        mActive = mBrightness.write(mMaxBrightness);
+        mThread->wake();
+    } else {
+        mActive = false;
+    }
+
+    mOnMs = onMs;
+    mOffMs = offMs;
+    return mActive;
+}
+
+void LedPattern::stop() {
+    std::lock_guard<std::mutex> lock(mLock);
+
+    if (!mActive) {
+        return;
+    }
+
+    mActive = false;
+
+    if (mHardwareTimer) {
+        stopHardware();
+    } else {
+        // Under the lock, so no edge can be written after this.
+        mLit = false;
+        mBrightness.write(0);
+        mThread->wake();
+    }
+}
+
+bool LedPattern::startHardware(uint32_t onMs, uint32_t offMs) {
+    // delay_on and delay_off only exist while the timer trigger is active.
+    if (WriteStringToFile("timer", mLedPath + "/trigger") &&
+        WriteStringToFile(std::to_string(onMs), mLedPath + "/delay_on") &&
+        WriteStringToFile(std::to_string(offMs), mLedPath + "/delay_off")) {
+        return true;
+    }
+
+    PLOG(ERROR) << "Failed to start the LED timer trigger";
+    stopHardware();
+    return false;
+}
+
+void LedPattern::stopHardware() {
+    // Removing the trigger also turns the LED off.
+    WriteStringToFile("none", mLedPath + "/trigger");
+}
+
+/*
+ * Runs on the scheduler thread. Returns when the next edge is due, or 0
+ * while the LED holds its state.
+ */
+int64_t LedPattern::step() {
+    std::lock_guard<std::mutex> lock(mLock);
+
+    if (!mActive || mOffMs == 0) {
+        return 0;
+    }
+
+    int64_t now = mThread->now();
+    if (now < mNextEdgeNs) {
+        return mNextEdgeNs;
+    }
+
+    mLit = !mLit;
+    mBrightness.write(mLit ? mMaxBrightness : 0);
+
+    mNextEdgeNs = now + (mLit ? mOnMs : mOffMs) * 1000000LL;
+    return mNextEdgeNs;
+}
+
+}  // namespace implementation
+}  // namespace V2_0
+}  // namespace light
+}  // namespace hardware
+}  // namespace android
@@ -0,0 +1,88 @@
+/*
+ * Copyright (C) 2020 The MoKee Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANDROID_HARDWARE_LIGHT_V2_0_LEDPATTERN_H
+#define ANDROID_HARDWARE_LIGHT_V2_0_LEDPATTERN_H
+
+#include <meizu/SysfsNode.h>
+#include <meizu/TimerThread.h>
+
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace android {
+namespace hardware {
+namespace light {
+namespace V2_0 {
+namespace implementation {
+
+using ::meizu::sm8150::SysfsNode;
+using ::meizu::sm8150::TimerThread;
+
+/*
+ * Blinks an LED class device with the requested on/off timings.
+ *
+ * If the driver offers the "timer" trigger, the timings are handed to the
+ * kernel and nothing runs in userspace. Otherwise a scheduler thread
+ * toggles the brightness node, sleeping on a CLOCK_BOOTTIME_ALARM timer
+ * between edges so that the pattern keeps running in suspend.
+ */
+class LedPattern {
+  public:
+    explicit LedPattern(const std::string& ledPath);
+    ~LedPattern();
+
+    // False if neither the timer trigger nor the scheduler can be used.
+    bool supported() const;
+
+    // onMs must be non-zero. An offMs of 0 keeps the LED on. Returns false,
+    // with the LED off, if the pattern could not be started.
+    bool start(uint32_t onMs, uint32_t offMs);
+    // The LED is off once this returns.
+    void stop();
+
+  private:
+    bool startHardware(uint32_t onMs, uint32_t offMs);
+    void stopHardware();
+
+    int64_t step();
+
+    std::string mLedPath;
+    bool mHardwareTimer;
+
+    // Guards the pattern and serializes every write to the LED.
+    std::mutex mLock;
+    bool mActive;
+    uint32_t mOnMs;
+    uint32_t mOffMs;
+
+    // Software scheduler state.
+    SysfsNode mBrightness;
+    int32_t mMaxBrightness;
+    bool mLit;
+    int64_t mNextEdgeNs;
+
+    std::unique_ptr<TimerThread> mThread;
+};
+
+}  // namespace implementation
+}  // namespace V2_0
+}  // namespace light
+}  // namespace hardware
+}  // namespace android
+
+#endif  // ANDROID_HARDWARE_LIGHT_V2_0_LEDPATTERN_H
@@ -18,29 +18,53 @@
 
 #include "Light.h"
 
+#include <android-base/file.h>
 #include <android-base/logging.h>
-#include <fstream>
 
-#define PANEL_BRIGHTNESS_PATH "/sys/class/backlight/panel0-backlight/brightness"
-#define PANEL_MAX_BRIGHTNESS_PATH "/sys/class/backlight/panel0-backlight/max_brightness"
-#define MX_LED_BLINK_PATH LIGHT_MX_LED_PATH "/blink"
-
-#define LED_OFF 0
-#define LED_BLINK 10
+using android::base::WriteStringToFd;
 
 namespace {
+using android::hardware::light::V2_0::Flash;
 using android::hardware::light::V2_0::LightState;
+using android::hardware::light::V2_0::Type;
+using android::hardware::light::V2_0::implementation::LedState;
+using android::hardware::light::V2_0::implementation::LightController;
+
+static LedState toLedState(const LightState& state) {
+    LedState ledState;
+
+    ledState.color = state.color;
+    switch (state.flashMode) {
+        case Flash::TIMED:
+            ledState.flashMode = LedState::Flash::TIMED;
+            break;
+        case Flash::HARDWARE:
+            ledState.flashMode = LedState::Flash::HARDWARE;
+            break;
+        default:
+            ledState.flashMode = LedState::Flash::NONE;
+            break;
+    }
+    ledState.flashOnMs = state.flashOnMs;
+    ledState.flashOffMs = state.flashOffMs;
 
-static constexpr int DEFAULT_MAX_BRIGHTNESS = 255;
-
-static uint32_t rgbToBrightness(const LightState& state) {
-    uint32_t color = state.color & 0x00ffffff;
-    return ((77 * ((color >> 16) & 0xff)) + (150 * ((color >> 8) & 0xff)) +
-            (29 * (color & 0xff))) >> 8;
+    return ledState;
 }
 
-static bool isLit(const LightState& state) {
-    return (state.color & 0x00ffffff);
+static bool toControllerId(Type type, LightController::Id* id) {
+    switch (type) {
+        case Type::BACKLIGHT:
+            *id = LightController::Id::BACKLIGHT;
+            return true;
+        case Type::ATTENTION:
+            *id = LightController::Id::ATTENTION;
+            return true;
+        case Type::NOTIFICATIONS:
+            *id = LightController::Id::NOTIFICATIONS;
+            return true;
+        default:
+            return false;
+    }
 }
 }  // anonymous namespace
 
@@ -50,96 +74,114 @@ namespace light {
 namespace V2_0 {
 namespace implementation {
 
-/*
- * Write value to path and close file.
- */
-template <typename T>
-static void set(const std::string& path, const T& value) {
-    std::ofstream file(path);
-    file << value;
-}
-
-template <typename T>
-static T get(const std::string& path, const T& def) {
-    std::ifstream file(path);
-    T result;
-
-    file >> result;
-    return file.fail() ? def : result;
-}
-
-Light::Light() {
-    mPanelMaxBrightness = get(PANEL_MAX_BRIGHTNESS_PATH, DEFAULT_MAX_BRIGHTNESS);
+constexpr std::array<Light::Handler, Light::kTypeCount> Light::kHandlers = [] {
+    std::array<Handler, kTypeCount> handlers{};
+    handlers[static_cast<size_t>(Type::ATTENTION)] = &Light::setAttentionLight;
+    handlers[static_cast<size_t>(Type::BACKLIGHT)] = &Light::setPanelBacklight;
+    handlers[static_cast<size_t>(Type::NOTIFICATIONS)] = &Light::setNotificationLight;
+    return handlers;
+}();
+
+constexpr size_t Light::kSupportedTypeCount = [] {
+    size_t count = 0;
+    for (auto handler : kHandlers) {
+        count += handler != nullptr;
+    }
+    return count;
+}();
+
+constexpr std::array<Type, Light::kTypeCount> Light::kSupportedTypes = [] {
+    std::array<Type, kTypeCount> types{};
+    size_t count = 0;
+    for (size_t i = 0; i < kHandlers.size(); i++) {
+        if (kHandlers[i] != nullptr) {
+            types[count++] = static_cast<Type>(i);
+        }
+    }
+    return types;
+}();
 
-    auto attnFn(std::bind(&Light::setAttentionLight, this, std::placeholders::_1));
-    auto backlightFn(std::bind(&Light::setPanelBacklight, this, std::placeholders::_1));
-    auto notifFn(std::bind(&Light::setNotificationLight, this, std::placeholders::_1));
-    mLights.emplace(std::make_pair(Type::ATTENTION, attnFn));
-    mLights.emplace(std::make_pair(Type::BACKLIGHT, backlightFn));
-    mLights.emplace(std::make_pair(Type::NOTIFICATIONS, notifFn));
-}
+Light::Light(const LightController::Config& config) : mController(config) {}
 
 // Methods from ::android::hardware::light::V2_0::ILight follow.
 Return<Status> Light::setLight(Type type, const LightState& state) {
-    auto it = mLights.find(type);
+    size_t index = static_cast<size_t>(type);
 
-    if (it == mLights.end()) {
+    if (index >= kHandlers.size() || kHandlers[index] == nullptr) {
         return Status::LIGHT_NOT_SUPPORTED;
     }
 
-    it->second(state);
+    (this->*kHandlers[index])(state);
 
     return Status::SUCCESS;
 }
 
 Return<void> Light::getSupportedTypes(getSupportedTypes_cb _hidl_cb) {
-    std::vector<Type> types;
-
-    for (auto const& light : mLights) {
-        types.push_back(light.first);
-    }
+    hidl_vec<Type> types;
 
+    types.setToExternal(const_cast<Type*>(kSupportedTypes.data()), kSupportedTypeCount);
     _hidl_cb(types);
 
     return Void();
 }
 
-void Light::setAttentionLight(const LightState& state) {
-    std::lock_guard<std::mutex> lock(mLock);
-    mAttentionState = state;
-    setSpeakerBatteryLightLocked();
+// Methods from ::vendor::meizu::hardware::light::V1_0::ILightExt follow.
+Return<void> Light::setLights(const hidl_vec<LightUpdate>& updates, setLights_cb _hidl_cb) {
+    std::vector<LightController::Update> batch;
+
+    batch.reserve(updates.size());
+    for (const auto& update : updates) {
+        LightController::Id id;
+
+        if (!toControllerId(update.type, &id)) {
+            _hidl_cb(Status::LIGHT_NOT_SUPPORTED, 0);
+            return Void();
+        }
+        batch.push_back({id, toLedState(update.state)});
+    }
+
+    int64_t applyTimeNs = mController.applyBatch(batch);
+    _hidl_cb(Status::SUCCESS, applyTimeNs);
+
+    return Void();
 }
 
-void Light::setPanelBacklight(const LightState& state) {
-    std::lock_guard<std::mutex> lock(mLock);
+Return<Status> Light::rampBacklight(const LightState& state, uint32_t durationMs) {
+    mController.rampBacklight(toLedState(state), durationMs);
+
+    return Status::SUCCESS;
+}
 
-    uint32_t brightness = rgbToBrightness(state);
+// Methods from ::android::hidl::base::V1_0::IBase follow.
+Return<void> Light::debug(const hidl_handle& handle, const hidl_vec<hidl_string>& args) {
+    const native_handle_t* nativeHandle = handle.getNativeHandle();
+    if (nativeHandle == nullptr || nativeHandle->numFds < 1) {
+        LOG(ERROR) << "debug: invalid handle";
+        return Void();
+    }
 
-    // If max panel brightness is not the default (255),
-    // apply linear scaling across the accepted range.
-    if (mPanelMaxBrightness != DEFAULT_MAX_BRIGHTNESS) {
-        int old_brightness = brightness;
-        brightness = brightness * mPanelMaxBrightness / DEFAULT_MAX_BRIGHTNESS;
-        LOG(VERBOSE) << "scaling brightness " << old_brightness << " => " << brightness;
+    for (const auto& arg : args) {
+        if (arg == "--reset") {
+            mController.resetStats();
+        } else if (arg == "--resync") {
+            mController.resync();
+        }
     }
 
-    set(PANEL_BRIGHTNESS_PATH, brightness);
+    WriteStringToFd(mController.dump(), nativeHandle->data[0]);
+    return Void();
 }
 
-void Light::setNotificationLight(const LightState& state) {
-    std::lock_guard<std::mutex> lock(mLock);
-    mNotificationState = state;
-    setSpeakerBatteryLightLocked();
+void Light::setAttentionLight(const LightState& state) {
+    mController.setAttention(toLedState(state));
 }
 
-void Light::setSpeakerBatteryLightLocked() {
-    if (isLit(mNotificationState)) {
-        set(MX_LED_BLINK_PATH, LED_BLINK);
-    } else if (isLit(mAttentionState)) {
-        set(MX_LED_BLINK_PATH, LED_BLINK);
-    } else {
-        set(MX_LED_BLINK_PATH, LED_OFF);
-    }
+void Light::setPanelBacklight(const LightState& state) {
+    mController.setBacklight(toLedState(state));
+}
+
+void Light::setNotificationLight(const LightState& state) {
+    mController.setNotification(toLedState(state));
 }
 
 }  // namespace implementation
@@ -19,9 +19,12 @@
 
 #include <android/hardware/light/2.0/ILight.h>
 #include <hidl/Status.h>
+#include <vendor/meizu/hardware/light/1.0/ILightExt.h>
 
-#include <mutex>
-#include <unordered_map>
+#include <array>
+#include <string>
+
+#include "LightController.h"
 
 namespace android {
 namespace hardware {
@@ -29,26 +32,38 @@ namespace light {
 namespace V2_0 {
 namespace implementation {
 
-struct Light : public ILight {
-    Light();
+using ::vendor::meizu::hardware::light::V1_0::ILightExt;
+using ::vendor::meizu::hardware::light::V1_0::LightUpdate;
+
+struct Light : public ILightExt {
+    explicit Light(const LightController::Config& config);
 
     // Methods from ::android::hardware::light::V2_0::ILight follow.
     Return<Status> setLight(Type type, const LightState& state) override;
     Return<void> getSupportedTypes(getSupportedTypes_cb _hidl_cb) override;
 
+    // Methods from ::vendor::meizu::hardware::light::V1_0::ILightExt follow.
+    Return<void> setLights(const hidl_vec<LightUpdate>& updates, setLights_cb _hidl_cb) override;
+    Return<Status> rampBacklight(const LightState& state, uint32_t durationMs) override;
+
+    // Methods from ::android::hidl::base::V1_0::IBase follow.
+    Return<void> debug(const hidl_handle& handle, const hidl_vec<hidl_string>& args) override;
+
   private:
+    using Handler = void (Light::*)(const LightState&);
+    static constexpr size_t kTypeCount = static_cast<size_t>(Type::COUNT);
+
+    // Handlers indexed by Type, nullptr for unsupported types.
+    static const std::array<Handler, kTypeCount> kHandlers;
+    // The types with a handler, in the first kSupportedTypeCount entries.
+    static const std::array<Type, kTypeCount> kSupportedTypes;
+    static const size_t kSupportedTypeCount;
+
     void setAttentionLight(const LightState& state);
     void setPanelBacklight(const LightState& state);
     void setNotificationLight(const LightState& state);
-    void setSpeakerBatteryLightLocked();
-
-    int mPanelMaxBrightness;
-
-    LightState mAttentionState;
-    LightState mNotificationState;
 
-    std::unordered_map<Type, std::function<void(const LightState&)>> mLights;
-    std::mutex mLock;
+    LightController mController;
 };
 
 }  // namespace implementation
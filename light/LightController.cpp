@@ -0,0 +1,336 @@
+/*
+ * Copyright (C) 2019-2020 The MoKee Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "LightService"
+
+#include "LightController.h"
+
+#include <android-base/logging.h>
+#include <android-base/stringprintf.h>
+#include <cutils/trace.h>
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+
+#define PANEL_BRIGHTNESS_PATH "/sys/class/backlight/panel0-backlight/brightness"
+#define PANEL_MAX_BRIGHTNESS_PATH "/sys/class/backlight/panel0-backlight/max_brightness"
+
+#define LED_OFF 0
+#define LED_BLINK 10
+
+using android::base::StringAppendF;
+using meizu::sm8150::monotonicNs;
+
+namespace {
+using android::hardware::light::V2_0::implementation::LedState;
+using android::hardware::light::V2_0::implementation::LightController;
+
+static constexpr int DEFAULT_MAX_BRIGHTNESS = 255;
+
+static uint32_t rgbToBrightness(const LedState& state) {
+    uint32_t color = state.color & 0x00ffffff;
+    return ((77 * ((color >> 16) & 0xff)) + (150 * ((color >> 8) & 0xff)) +
+            (29 * (color & 0xff))) >> 8;
+}
+
+static bool isLit(const LedState& state) {
+    return (state.color & 0x00ffffff);
+}
+
+static bool isTimed(const LedState& state) {
+    return state.flashMode == LedState::Flash::TIMED && state.flashOnMs > 0 &&
+           state.flashOffMs >= 0;
+}
+
+static const char* kIdNames[] = {"backlight", "attention", "notifications"};
+static const char* kLockWaitCounters[] = {
+        "light.backlight.lock_wait_ns",
+        "light.attention.lock_wait_ns",
+        "light.notifications.lock_wait_ns",
+};
+static const char* kWriteCounters[] = {
+        "light.backlight.write_ns",
+        "light.attention.write_ns",
+        "light.notifications.write_ns",
+};
+
+static_assert(sizeof(kIdNames) / sizeof(kIdNames[0]) ==
+                      static_cast<size_t>(LightController::Id::COUNT),
+              "kIdNames must cover every LightController::Id");
+}  // anonymous namespace
+
+namespace android {
+namespace hardware {
+namespace light {
+namespace V2_0 {
+namespace implementation {
+
+template <typename T>
+static T get(const std::string& path, const T& def) {
+    std::ifstream file(path);
+    T result;
+
+    file >> result;
+    return file.fail() ? def : result;
+}
+
+LightController::LightController(const Config& config)
+    : mPanelBrightness(config.sysfsRoot + PANEL_BRIGHTNESS_PATH),
+      mMxLedBlink(config.sysfsRoot + config.mxLedPath + "/blink"),
+      mLedPattern(config.sysfsRoot + config.mxLedPath),
+      mPanelOff(true),
+      mBacklightLevel(0),
+      mRamp(config.rampPeriodUs, [this](float level) { onRampStep(level); }) {
+    int maxBrightness = get(config.sysfsRoot + PANEL_MAX_BRIGHTNESS_PATH, DEFAULT_MAX_BRIGHTNESS);
+    float gamma = config.brightnessGammaPath.empty()
+                          ? 1.0f
+                          : get(config.brightnessGammaPath, 1.0f);
+
+    LOG(INFO) << "Panel max brightness " << maxBrightness << ", gamma " << gamma;
+    buildBrightnessTable(mBrightnessTable, maxBrightness, gamma);
+
+    if (config.backlightWriteMode == BacklightWriteMode::ASYNC) {
+        mBacklightWriter = std::make_unique<BacklightWriter>(mPanelBrightness);
+    }
+}
+
+void LightController::setBacklight(const LedState& state) {
+    mRamp.cancel();
+
+    uint32_t level = rgbToBrightness(state);
+    mBacklightLevel.store(level);
+    uint32_t brightness = toPanelBrightness(level);
+
+    if (mBacklightWriter) {
+        mBacklightWriter->publish(brightness);
+        return;
+    }
+
+    auto lock = lockTimed(Id::BACKLIGHT);
+    writeBacklightLocked(brightness);
+}
+
+void LightController::setAttention(const LedState& state) {
+    auto lock = lockTimed(Id::ATTENTION);
+    mAttentionState = state;
+
+    int64_t start = monotonicNs();
+    setSpeakerBatteryLightLocked();
+    recordWrite(Id::ATTENTION, start);
+}
+
+void LightController::setNotification(const LedState& state) {
+    auto lock = lockTimed(Id::NOTIFICATIONS);
+    mNotificationState = state;
+
+    int64_t start = monotonicNs();
+    setSpeakerBatteryLightLocked();
+    recordWrite(Id::NOTIFICATIONS, start);
+}
+
+void LightController::rampBacklight(const LedState& state, uint32_t durationMs) {
+    // Not under mLock, ramp steps take it while holding the ramp's own lock.
+    mRamp.start(mBacklightLevel.load(), rgbToBrightness(state), durationMs);
+}
+
+int64_t LightController::applyBatch(const std::vector<Update>& updates) {
+    int64_t start = monotonicNs();
+    const LedState* backlight = nullptr;
+    bool ledChanged = false;
+
+    for (const auto& update : updates) {
+        if (update.id == Id::BACKLIGHT) {
+            mRamp.cancel();
+            break;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mLock);
+
+    for (const auto& update : updates) {
+        switch (update.id) {
+            case Id::BACKLIGHT:
+                backlight = &update.state;
+                break;
+            case Id::ATTENTION:
+                mAttentionState = update.state;
+                ledChanged = true;
+                break;
+            case Id::NOTIFICATIONS:
+                mNotificationState = update.state;
+                ledChanged = true;
+                break;
+            default:
+                break;
+        }
+    }
+
+    if (backlight != nullptr) {
+        uint32_t level = rgbToBrightness(*backlight);
+        mBacklightLevel.store(level);
+        uint32_t brightness = toPanelBrightness(level);
+        if (mBacklightWriter) {
+            mBacklightWriter->publish(brightness);
+        } else {
+            writeBacklightLocked(brightness);
+        }
+    }
+
+    if (ledChanged) {
+        setSpeakerBatteryLightLocked();
+    }
+
+    int64_t elapsed = monotonicNs() - start;
+    mBatchApply.record(elapsed);
+    return elapsed;
+}
+
+void LightController::resync() {
+    mPanelBrightness.invalidate();
+    mMxLedBlink.invalidate();
+}
+
+void LightController::resetStats() {
+    for (auto& stats : mStats) {
+        stats.lockWait.reset();
+        stats.write.reset();
+    }
+    mBatchApply.reset();
+}
+
+std::string LightController::dump() const {
+    std::string out;
+
+    for (size_t i = 0; i < kIdCount; i++) {
+        std::string name = kIdNames[i];
+        out += mStats[i].lockWait.dump(name + " lock wait");
+        out += mStats[i].write.dump(name + " write");
+    }
+    out += mBatchApply.dump("batch apply");
+
+    for (const SysfsNode* node : {&mPanelBrightness, &mMxLedBlink}) {
+        StringAppendF(&out, "%s: cache hits=%llu misses=%llu\n", node->path().c_str(),
+                      static_cast<unsigned long long>(node->cacheHits()),
+                      static_cast<unsigned long long>(node->cacheMisses()));
+    }
+
+    if (mBacklightWriter) {
+        out += mBacklightWriter->writeLatency().dump("async backlight write");
+        StringAppendF(&out, "async backlight coalesced=%llu\n",
+                      static_cast<unsigned long long>(mBacklightWriter->coalescedWrites()));
+    }
+
+    return out;
+}
+
+/*
+ * Acquire mLock, recording how long the caller waited for it.
+ */
+std::unique_lock<std::mutex> LightController::lockTimed(Id id) {
+    int64_t start = monotonicNs();
+    std::unique_lock<std::mutex> lock(mLock);
+    int64_t waited = monotonicNs() - start;
+
+    size_t index = static_cast<size_t>(id);
+    mStats[index].lockWait.record(waited);
+    if (atrace_is_tag_enabled(ATRACE_TAG_HAL)) {
+        atrace_int64(ATRACE_TAG_HAL, kLockWaitCounters[index], waited);
+    }
+
+    return lock;
+}
+
+void LightController::recordWrite(Id id, int64_t startNs) {
+    int64_t elapsed = monotonicNs() - startNs;
+
+    size_t index = static_cast<size_t>(id);
+    mStats[index].write.record(elapsed);
+    if (atrace_is_tag_enabled(ATRACE_TAG_HAL)) {
+        atrace_int64(ATRACE_TAG_HAL, kWriteCounters[index], elapsed);
+    }
+}
+
+/*
+ * Map a framework level to the panel, interpolating between table
+ * entries for the fractional levels produced by ramps.
+ */
+uint32_t LightController::toPanelBrightness(float level) {
+    level = std::min(std::max(level, 0.0f), static_cast<float>(mBrightnessTable.size() - 1));
+
+    size_t index = static_cast<size_t>(level);
+    uint32_t brightness = mBrightnessTable[index];
+
+    float fraction = level - index;
+    if (fraction > 0.0f) {
+        int32_t delta = mBrightnessTable[index + 1] - brightness;
+        brightness += std::lround(fraction * delta);
+    }
+
+    // The panel and LED drivers may reset their state while the screen is off.
+    if (mPanelOff.exchange(brightness == 0) && brightness != 0) {
+        resync();
+    }
+
+    return brightness;
+}
+
+void LightController::writeBacklightLocked(uint32_t brightness) {
+    int64_t start = monotonicNs();
+    mPanelBrightness.write(brightness);
+    recordWrite(Id::BACKLIGHT, start);
+}
+
+void LightController::onRampStep(float level) {
+    mBacklightLevel.store(level);
+    uint32_t brightness = toPanelBrightness(level);
+
+    if (mBacklightWriter) {
+        mBacklightWriter->publish(brightness);
+        return;
+    }
+
+    auto lock = lockTimed(Id::BACKLIGHT);
+    writeBacklightLocked(brightness);
+}
+
+void LightController::setSpeakerBatteryLightLocked() {
+    const LedState* state = nullptr;
+
+    if (isLit(mNotificationState)) {
+        state = &mNotificationState;
+    } else if (isLit(mAttentionState)) {
+        state = &mAttentionState;
+    }
+
+    if (state == nullptr) {
+        mLedPattern.stop();
+        mMxLedBlink.write(LED_OFF);
+    } else if (isTimed(*state) && mLedPattern.supported()) {
+        mMxLedBlink.write(LED_OFF);
+        if (!mLedPattern.start(state->flashOnMs, state->flashOffMs)) {
+            mMxLedBlink.write(LED_BLINK);
+        }
+    } else {
+        mLedPattern.stop();
+        mMxLedBlink.write(LED_BLINK);
+    }
+}
+
+}  // namespace implementation
+}  // namespace V2_0
+}  // namespace light
+}  // namespace hardware
+}  // namespace android
@@ -0,0 +1,153 @@
+/*
+ * Copyright (C) 2020 The MoKee Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANDROID_HARDWARE_LIGHT_V2_0_LIGHTCONTROLLER_H
+#define ANDROID_HARDWARE_LIGHT_V2_0_LIGHTCONTROLLER_H
+
+#include <meizu/LatencyHistogram.h>
+#include <meizu/SysfsNode.h>
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "BacklightRamp.h"
+#include "BacklightWriter.h"
+#include "BrightnessTable.h"
+#include "LedPattern.h"
+
+namespace android {
+namespace hardware {
+namespace light {
+namespace V2_0 {
+namespace implementation {
+
+using ::meizu::sm8150::LatencyHistogram;
+using ::meizu::sm8150::SysfsNode;
+
+// Mirrors ILight's LightState without depending on HIDL.
+struct LedState {
+    enum class Flash { NONE, TIMED, HARDWARE };
+
+    uint32_t color = 0;
+    Flash flashMode = Flash::NONE;
+    int32_t flashOnMs = 0;
+    int32_t flashOffMs = 0;
+};
+
+/*
+ * The panel backlight and mx_led state machine behind the Light HAL.
+ *
+ * Arbitrates between the attention and notification lights, maps
+ * backlight levels to the panel and selects the LED blink mode. It only
+ * talks to sysfs, so it can run on the host against a fake tree.
+ */
+class LightController {
+  public:
+    enum class Id { BACKLIGHT, ATTENTION, NOTIFICATIONS, COUNT };
+
+    enum class BacklightWriteMode {
+        // Write on the calling thread under the controller lock.
+        SYNC,
+        // Coalesce levels and write them on a BacklightWriter thread.
+        ASYNC,
+    };
+
+    struct Config {
+        // Prepended to every sysfs path.
+        std::string sysfsRoot;
+        // The mx_led LED class device, without sysfsRoot.
+        std::string mxLedPath;
+        // Optional file holding a gamma exponent for the brightness curve.
+        std::string brightnessGammaPath;
+        BacklightWriteMode backlightWriteMode = BacklightWriteMode::SYNC;
+        // Step period of backlight ramps, normally the panel refresh period.
+        uint32_t rampPeriodUs = 16667;
+    };
+
+    struct Update {
+        Id id;
+        LedState state;
+    };
+
+    explicit LightController(const Config& config);
+
+    void setBacklight(const LedState& state);
+    void setAttention(const LedState& state);
+    void setNotification(const LedState& state);
+
+    // Fade the backlight to the brightness of state. Any later backlight update cancels it.
+    void rampBacklight(const LedState& state, uint32_t durationMs);
+
+    // Apply updates under a single lock acquisition, writing each node at most once.
+    // Returns the time spent applying them, in ns.
+    int64_t applyBatch(const std::vector<Update>& updates);
+
+    // Forget the last values written to sysfs so that the next update reaches the driver.
+    void resync();
+
+    void resetStats();
+    std::string dump() const;
+
+  private:
+    static constexpr size_t kIdCount = static_cast<size_t>(Id::COUNT);
+
+    struct Stats {
+        LatencyHistogram lockWait;
+        LatencyHistogram write;
+    };
+
+    std::unique_lock<std::mutex> lockTimed(Id id);
+    void recordWrite(Id id, int64_t startNs);
+
+    uint32_t toPanelBrightness(float level);
+    void writeBacklightLocked(uint32_t brightness);
+    void onRampStep(float level);
+    void setSpeakerBatteryLightLocked();
+
+    BrightnessTable mBrightnessTable;
+
+    SysfsNode mPanelBrightness;
+    SysfsNode mMxLedBlink;
+    LedPattern mLedPattern;
+
+    std::unique_ptr<BacklightWriter> mBacklightWriter;
+    std::atomic<bool> mPanelOff;
+    // Current backlight in framework units, fractional while ramping.
+    std::atomic<float> mBacklightLevel;
+
+    LedState mAttentionState;
+    LedState mNotificationState;
+
+    std::mutex mLock;
+
+    std::array<Stats, kIdCount> mStats;
+    LatencyHistogram mBatchApply;
+
+    // Last, so that its thread stops before anything it touches is destroyed.
+    BacklightRamp mRamp;
+};
+
+}  // namespace implementation
+}  // namespace V2_0
+}  // namespace light
+}  // namespace hardware
+}  // namespace android
+
+#endif  // ANDROID_HARDWARE_LIGHT_V2_0_LIGHTCONTROLLER_H
@@ -17,6 +17,7 @@
 #define LOG_TAG "android.hardware.light@2.0-service.meizu_sm8150"
 
 #include <android-base/logging.h>
+#include <android-base/properties.h>
 #include <hidl/HidlTransportSupport.h>
 #include <utils/Errors.h>
 
@@ -26,12 +27,25 @@
 using android::hardware::configureRpcThreadpool;
 using android::hardware::joinRpcThreadpool;
 
+using android::base::GetBoolProperty;
+using android::base::GetUintProperty;
+
 // Generated HIDL files
-using android::hardware::light::V2_0::ILight;
+using vendor::meizu::hardware::light::V1_0::ILightExt;
 using android::hardware::light::V2_0::implementation::Light;
+using android::hardware::light::V2_0::implementation::LightController;
 
 int main() {
-    android::sp<ILight> service = new Light();
+    LightController::Config config;
+    config.mxLedPath = LIGHT_MX_LED_PATH;
+    config.brightnessGammaPath = "/vendor/etc/light/brightness_gamma";
+    if (GetBoolProperty("ro.vendor.light.async_backlight", false)) {
+        config.backlightWriteMode = LightController::BacklightWriteMode::ASYNC;
+    }
+    config.rampPeriodUs = GetUintProperty<uint32_t>("ro.vendor.light.ramp_period_us",
+                                                    config.rampPeriodUs);
+
+    android::sp<ILightExt> service = new Light(config);
 
     configureRpcThreadpool(1, true);
 
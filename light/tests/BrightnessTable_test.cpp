@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2020 The MoKee Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "BrightnessTable.h"
+
+using android::hardware::light::V2_0::implementation::BrightnessTable;
+using android::hardware::light::V2_0::implementation::buildBrightnessTable;
+
+namespace {
+
+constexpr int kMaxBrightnessValues[] = {1, 255, 1023, 2047, 4095};
+
+// The scaling setPanelBacklight() did on every call before the table.
+uint32_t linearBrightness(uint32_t level, int maxBrightness) {
+    return level * maxBrightness / 255;
+}
+
+TEST(BrightnessTableTest, MatchesLinearFormula) {
+    for (int maxBrightness : kMaxBrightnessValues) {
+        for (float gamma : {1.0f, 0.0f, -1.0f}) {
+            BrightnessTable table;
+            buildBrightnessTable(table, maxBrightness, gamma);
+
+            for (uint32_t level = 0; level < table.size(); level++) {
+                EXPECT_EQ(linearBrightness(level, maxBrightness), table[level])
+                        << "max " << maxBrightness << " gamma " << gamma << " level " << level;
+            }
+        }
+    }
+}
+
+TEST(BrightnessTableTest, GammaCurveKeepsEndpoints) {
+    for (int maxBrightness : kMaxBrightnessValues) {
+        BrightnessTable table;
+        buildBrightnessTable(table, maxBrightness, 2.2f);
+
+        EXPECT_EQ(0u, table.front());
+        EXPECT_EQ(static_cast<uint32_t>(maxBrightness), table.back());
+    }
+}
+
+TEST(BrightnessTableTest, GammaCurveIsMonotonicAndNeverOff) {
+    BrightnessTable table;
+    buildBrightnessTable(table, 1023, 2.2f);
+
+    for (uint32_t level = 1; level < table.size(); level++) {
+        EXPECT_GE(table[level], table[level - 1]) << "level " << level;
+        EXPECT_GT(table[level], 0u) << "level " << level;
+    }
+}
+
+TEST(BrightnessTableTest, GammaAboveOneDimsLowEnd) {
+    BrightnessTable table;
+    buildBrightnessTable(table, 1023, 2.2f);
+
+    for (uint32_t level = 1; level < table.size() - 1; level++) {
+        EXPECT_LE(table[level], linearBrightness(level, 1023)) << "level " << level;
+    }
+}
+
+}  // anonymous namespace
@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 2020 The MoKee Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MEIZU_SM8150_LIGHT_TESTS_FAKESYSFSTREE_H
+#define MEIZU_SM8150_LIGHT_TESTS_FAKESYSFSTREE_H
+
+#include <meizu/ScratchSysfs.h>
+
+#include <string>
+
+#include "LightController.h"
+
+namespace android {
+namespace hardware {
+namespace light {
+namespace V2_0 {
+namespace implementation {
+
+/*
+ * The panel backlight and mx_led nodes in a scratch directory, for running
+ * LightController off-device through Config::sysfsRoot.
+ */
+class FakeSysfsTree : public ::meizu::sm8150::ScratchSysfs {
+  public:
+    static constexpr const char* kPanelBrightness =
+            "/sys/class/backlight/panel0-backlight/brightness";
+    static constexpr const char* kPanelMaxBrightness =
+            "/sys/class/backlight/panel0-backlight/max_brightness";
+    static constexpr const char* kLedPath = "/sys/class/leds/mx-led";
+
+    // With timerTrigger, the LED offers the kernel "timer" trigger.
+    explicit FakeSysfsTree(int maxBrightness = 1023, bool timerTrigger = false) {
+        create(kPanelBrightness, "0");
+        create(kPanelMaxBrightness, std::to_string(maxBrightness));
+        create(led("blink"), "0");
+        create(led("brightness"), "0");
+        create(led("max_brightness"), "255");
+        if (timerTrigger) {
+            create(led("trigger"), "[none] timer");
+            create(led("delay_on"), "0");
+            create(led("delay_off"), "0");
+        }
+    }
+
+    LightController::Config config(LightController::BacklightWriteMode mode =
+                                           LightController::BacklightWriteMode::SYNC) const {
+        LightController::Config config;
+
+        config.sysfsRoot = root();
+        config.mxLedPath = kLedPath;
+        config.backlightWriteMode = mode;
+        return config;
+    }
+
+    static std::string led(const std::string& node) { return std::string(kLedPath) + "/" + node; }
+};
+
+}  // namespace implementation
+}  // namespace V2_0
+}  // namespace light
+}  // namespace hardware
+}  // namespace android
+
+#endif  // MEIZU_SM8150_LIGHT_TESTS_FAKESYSFSTREE_H
@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2020 The MoKee Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include "FakeSysfsTree.h"
+
+using android::hardware::light::V2_0::implementation::FakeSysfsTree;
+using android::hardware::light::V2_0::implementation::LedState;
+using android::hardware::light::V2_0::implementation::LightController;
+
+namespace {
+
+using WriteMode = LightController::BacklightWriteMode;
+
+// Two distinct states, or the same one twice to measure shadow cache hits.
+void makeStates(LedState (&states)[2], bool alternate) {
+    states[0].color = 0xff404040;
+    states[1].color = alternate ? 0xff808080 : states[0].color;
+}
+
+/*
+ * Backlight updates per second for each write strategy. SYNC pays for the
+ * write on the caller, ASYNC only publishes the level to the writer thread.
+ */
+void BM_setBacklight(benchmark::State& state) {
+    FakeSysfsTree tree;
+    LightController controller(tree.config(static_cast<WriteMode>(state.range(0))));
+    LedState states[2];
+    size_t i = 0;
+
+    makeStates(states, state.range(1));
+
+    for (auto _ : state) {
+        controller.setBacklight(states[i++ & 1]);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_setBacklight)
+        ->ArgNames({"async", "alternate"})
+        ->Args({static_cast<int>(WriteMode::SYNC), 0})
+        ->Args({static_cast<int>(WriteMode::SYNC), 1})
+        ->Args({static_cast<int>(WriteMode::ASYNC), 0})
+        ->Args({static_cast<int>(WriteMode::ASYNC), 1});
+
+// Notification updates toggling the LED between off and blinking.
+void BM_setNotification(benchmark::State& state) {
+    FakeSysfsTree tree;
+    LightController controller(tree.config());
+    LedState states[2];
+    size_t i = 0;
+
+    states[0].color = 0xff00ff00;
+    states[1].color = state.range(0) ? 0 : states[0].color;
+
+    for (auto _ : state) {
+        controller.setNotification(states[i++ & 1]);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_setNotification)->ArgName("alternate")->Arg(0)->Arg(1);
+
+// A backlight, attention and notification update applied as one batch.
+void BM_applyBatch(benchmark::State& state) {
+    FakeSysfsTree tree;
+    LightController controller(tree.config(static_cast<WriteMode>(state.range(0))));
+    LedState states[2];
+    std::vector<LightController::Update> batches[2];
+
+    makeStates(states, true);
+    for (size_t i = 0; i < 2; i++) {
+        batches[i] = {
+                {LightController::Id::BACKLIGHT, states[i]},
+                {LightController::Id::ATTENTION, states[i]},
+                {LightController::Id::NOTIFICATIONS, states[i ^ 1]},
+        };
+    }
+
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(controller.applyBatch(batches[i++ & 1]));
+    }
+    state.SetItemsProcessed(state.iterations() * 3);
+}
+
+BENCHMARK(BM_applyBatch)
+        ->ArgName("async")
+        ->Arg(static_cast<int>(WriteMode::SYNC))
+        ->Arg(static_cast<int>(WriteMode::ASYNC));
+
+}  // anonymous namespace
+
+BENCHMARK_MAIN();
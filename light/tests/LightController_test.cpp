@@ -0,0 +1,214 @@
+/*
+ * Copyright (C) 2020 The MoKee Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <android-base/file.h>
+#include <gtest/gtest.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <thread>
+
+#include "FakeSysfsTree.h"
+
+using android::base::WriteStringToFile;
+using android::hardware::light::V2_0::implementation::FakeSysfsTree;
+using android::hardware::light::V2_0::implementation::LedState;
+using android::hardware::light::V2_0::implementation::LightController;
+
+namespace {
+
+constexpr const char* kBlink = "/sys/class/leds/mx-led/blink";
+
+LedState lit(uint32_t color) {
+    LedState state;
+
+    state.color = color;
+    return state;
+}
+
+LedState timed(uint32_t color, int32_t onMs, int32_t offMs) {
+    LedState state = lit(color);
+
+    state.flashMode = LedState::Flash::TIMED;
+    state.flashOnMs = onMs;
+    state.flashOffMs = offMs;
+    return state;
+}
+
+// Waits for an asynchronous write to land.
+bool waitFor(const FakeSysfsTree& tree, const std::string& path, const std::string& value) {
+    for (int i = 0; i < 200; i++) {
+        if (tree.read(path) == value) {
+            return true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    return false;
+}
+
+TEST(LightControllerTest, BacklightScalesToPanel) {
+    FakeSysfsTree tree(1023);
+    LightController controller(tree.config());
+
+    // Grey 0x80 is level 128.
+    controller.setBacklight(lit(0xff808080));
+    EXPECT_EQ("513", tree.read(FakeSysfsTree::kPanelBrightness));
+
+    controller.setBacklight(lit(0xffffffff));
+    EXPECT_EQ("1023", tree.read(FakeSysfsTree::kPanelBrightness));
+
+    controller.setBacklight(lit(0xff000000));
+    EXPECT_EQ("0", tree.read(FakeSysfsTree::kPanelBrightness));
+}
+
+TEST(LightControllerTest, AsyncBacklightReachesPanel) {
+    FakeSysfsTree tree(1023);
+    LightController controller(tree.config(LightController::BacklightWriteMode::ASYNC));
+
+    for (uint32_t level = 1; level <= 255; level++) {
+        controller.setBacklight(lit(0xff000000 | level * 0x010101));
+    }
+
+    // Intermediate levels may be coalesced, the last one must not be.
+    EXPECT_TRUE(waitFor(tree, FakeSysfsTree::kPanelBrightness, "1023"));
+}
+
+TEST(LightControllerTest, LitNotificationBlinks) {
+    FakeSysfsTree tree;
+    LightController controller(tree.config());
+
+    controller.setNotification(lit(0xff00ff00));
+    EXPECT_EQ("10", tree.read(kBlink));
+
+    controller.setNotification(lit(0));
+    EXPECT_EQ("0", tree.read(kBlink));
+}
+
+TEST(LightControllerTest, AttentionShowsWithoutNotification) {
+    FakeSysfsTree tree;
+    LightController controller(tree.config());
+
+    controller.setAttention(lit(0xffff0000));
+    EXPECT_EQ("10", tree.read(kBlink));
+
+    // Clearing the notification keeps the attention light on.
+    controller.setNotification(lit(0));
+    EXPECT_EQ("10", tree.read(kBlink));
+
+    controller.setAttention(lit(0));
+    EXPECT_EQ("0", tree.read(kBlink));
+}
+
+TEST(LightControllerTest, TimedPatternUsesTimerTrigger) {
+    FakeSysfsTree tree(1023, true);
+    LightController controller(tree.config());
+
+    controller.setNotification(timed(0xff00ff00, 300, 1700));
+    EXPECT_EQ("0", tree.read(kBlink));
+    EXPECT_EQ("timer", tree.read(FakeSysfsTree::led("trigger")));
+    EXPECT_EQ("300", tree.read(FakeSysfsTree::led("delay_on")));
+    EXPECT_EQ("1700", tree.read(FakeSysfsTree::led("delay_off")));
+
+    controller.setNotification(lit(0));
+    EXPECT_EQ("none", tree.read(FakeSysfsTree::led("trigger")));
+    EXPECT_EQ("0", tree.read(kBlink));
+}
+
+TEST(LightControllerTest, NotificationPatternWinsOverAttention) {
+    FakeSysfsTree tree(1023, true);
+    LightController controller(tree.config());
+
+    controller.setAttention(timed(0xffff0000, 100, 200));
+    controller.setNotification(timed(0xff00ff00, 300, 400));
+    EXPECT_EQ("300", tree.read(FakeSysfsTree::led("delay_on")));
+    EXPECT_EQ("400", tree.read(FakeSysfsTree::led("delay_off")));
+
+    controller.setNotification(lit(0));
+    EXPECT_EQ("100", tree.read(FakeSysfsTree::led("delay_on")));
+    EXPECT_EQ("200", tree.read(FakeSysfsTree::led("delay_off")));
+}
+
+TEST(LightControllerTest, FailedTimerTriggerFallsBackToBlink) {
+    FakeSysfsTree tree(1023, true);
+
+    // A directory in place of delay_on fails the write even as root.
+    std::string delayOn = tree.path(FakeSysfsTree::led("delay_on"));
+    ASSERT_EQ(0, unlink(delayOn.c_str()));
+    ASSERT_EQ(0, mkdir(delayOn.c_str(), 0755));
+
+    LightController controller(tree.config());
+    controller.setNotification(timed(0xff00ff00, 300, 1700));
+
+    EXPECT_EQ("10", tree.read(kBlink));
+    EXPECT_EQ("none", tree.read(FakeSysfsTree::led("trigger")));
+}
+
+TEST(LightControllerTest, SoftwarePatternStartsLitAndStopsOff) {
+    FakeSysfsTree tree;
+    LightController controller(tree.config());
+
+    controller.setNotification(timed(0xff00ff00, 60000, 60000));
+    EXPECT_EQ("0", tree.read(kBlink));
+    EXPECT_EQ("255", tree.read(FakeSysfsTree::led("brightness")));
+
+    controller.setNotification(lit(0));
+    EXPECT_EQ("0", tree.read(FakeSysfsTree::led("brightness")));
+}
+
+TEST(LightControllerTest, ResyncRewritesCachedValues) {
+    FakeSysfsTree tree(1023);
+    LightController controller(tree.config());
+
+    controller.setBacklight(lit(0xff808080));
+    controller.setNotification(lit(0xff00ff00));
+
+    // The driver loses its state behind the HAL's back.
+    WriteStringToFile("0", tree.path(FakeSysfsTree::kPanelBrightness));
+    WriteStringToFile("0", tree.path(kBlink));
+
+    controller.setBacklight(lit(0xff808080));
+    controller.setNotification(lit(0xff00ff00));
+    EXPECT_EQ("0", tree.read(FakeSysfsTree::kPanelBrightness));
+    EXPECT_EQ("0", tree.read(kBlink));
+
+    controller.resync();
+    controller.setBacklight(lit(0xff808080));
+    controller.setNotification(lit(0xff00ff00));
+    EXPECT_EQ("513", tree.read(FakeSysfsTree::kPanelBrightness));
+    EXPECT_EQ("10", tree.read(kBlink));
+}
+
+TEST(LightControllerTest, BatchWritesEachNodeOnce) {
+    FakeSysfsTree tree(1023);
+    LightController controller(tree.config());
+
+    controller.applyBatch({
+            {LightController::Id::BACKLIGHT, lit(0xff202020)},
+            {LightController::Id::BACKLIGHT, lit(0xff808080)},
+            {LightController::Id::ATTENTION, lit(0xffff0000)},
+            {LightController::Id::NOTIFICATIONS, lit(0)},
+    });
+
+    EXPECT_EQ("513", tree.read(FakeSysfsTree::kPanelBrightness));
+    EXPECT_EQ("10", tree.read(kBlink));
+
+    std::string dump = controller.dump();
+    EXPECT_NE(std::string::npos, dump.find("panel0-backlight/brightness: cache hits=0 misses=1"))
+            << dump;
+}
+
+}  // anonymous namespace
@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2020 The MoKee Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include "FakeSysfsTree.h"
+#include "Light.h"
+
+using android::sp;
+using android::hardware::light::V2_0::LightState;
+using android::hardware::light::V2_0::Type;
+using android::hardware::light::V2_0::implementation::FakeSysfsTree;
+using android::hardware::light::V2_0::implementation::Light;
+
+namespace {
+
+/*
+ * ns per setLight() call through the Type-indexed handler table, with the
+ * nodes in a scratch directory standing in for the driver. Repeating the
+ * same state only costs the dispatch and a shadow cache hit. Alternating
+ * states also pays for the write: the backlight flips between two levels,
+ * the LEDs between lit and off, since every lit color blinks the same.
+ */
+void BM_setLight(benchmark::State& state) {
+    FakeSysfsTree tree;
+    sp<Light> light = new Light(tree.config());
+    Type type = static_cast<Type>(state.range(0));
+    bool alternate = state.range(1);
+    LightState lightState[2];
+    size_t i = 0;
+
+    lightState[0].color = 0xff404040;
+    lightState[1].color = lightState[0].color;
+    if (alternate) {
+        lightState[1].color = type == Type::BACKLIGHT ? 0xff808080 : 0;
+    }
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(light->setLight(type, lightState[i++ & 1]));
+    }
+    state.SetLabel(toString(type));
+}
+
+BENCHMARK(BM_setLight)
+        ->ArgNames({"type", "alternate"})
+        ->Args({static_cast<int>(Type::BACKLIGHT), 0})
+        ->Args({static_cast<int>(Type::BACKLIGHT), 1})
+        ->Args({static_cast<int>(Type::NOTIFICATIONS), 0})
+        ->Args({static_cast<int>(Type::NOTIFICATIONS), 1})
+        ->Args({static_cast<int>(Type::ATTENTION), 0})
+        ->Args({static_cast<int>(Type::ATTENTION), 1})
+        // Unsupported, only the table lookup.
+        ->Args({static_cast<int>(Type::BUTTONS), 0});
+
+}  // anonymous namespace
+
+BENCHMARK_MAIN();
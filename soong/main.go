@@ -7,4 +7,5 @@ import (
 func init() {
     android.RegisterModuleType("meizu_sm8150_fod_hal_binary", fodHalBinaryFactory)
     android.RegisterModuleType("meizu_sm8150_light_hal_binary", lightHalBinaryFactory)
+    android.RegisterModuleType("meizu_sm8150_vibrator_aidl_binary", vibratorAidlHalBinaryFactory)
 }
@@ -0,0 +1,29 @@
+package sm8150
+
+import (
+    "android/soong/android"
+    "android/soong/cc"
+
+    "github.com/google/blueprint/proptools"
+)
+
+// The AIDL service links the stable AIDL vibrator interface, which does not
+// exist before Android 11, so it is only enabled on boards that opt in.
+func vibratorAidlHalBinary(ctx android.LoadHookContext) {
+    type props struct {
+        Enabled *bool
+    }
+
+    var config = ctx.AConfig().VendorConfig("MEIZU_SM8150_VIBRATOR")
+
+    p := &props{}
+    p.Enabled = proptools.BoolPtr(config.Bool("AIDL"))
+    ctx.AppendProperties(p)
+}
+
+func vibratorAidlHalBinaryFactory() android.Module {
+    module, _ := cc.NewBinary(android.HostAndDeviceSupported)
+    newMod := module.Init()
+    android.AddLoadHook(newMod, vibratorAidlHalBinary)
+    return newMod
+}
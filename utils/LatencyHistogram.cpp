@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2020 The MoKee Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "meizu/LatencyHistogram.h"
+
+#include <android-base/stringprintf.h>
+
+using android::base::StringAppendF;
+
+namespace meizu {
+namespace sm8150 {
+
+LatencyHistogram::LatencyHistogram() {
+    reset();
+}
+
+void LatencyHistogram::record(int64_t ns) {
+    if (ns < 0) {
+        ns = 0;
+    }
+
+    mBuckets[bucketFor(ns)].fetch_add(1, std::memory_order_relaxed);
+    mCount.fetch_add(1, std::memory_order_relaxed);
+    mSumNs.fetch_add(ns, std::memory_order_relaxed);
+
+    int64_t max = mMaxNs.load(std::memory_order_relaxed);
+    while (ns > max && !mMaxNs.compare_exchange_weak(max, ns, std::memory_order_relaxed)) {
+    }
+}
+
+void LatencyHistogram::reset() {
+    for (auto& bucket : mBuckets) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    mCount.store(0, std::memory_order_relaxed);
+    mSumNs.store(0, std::memory_order_relaxed);
+    mMaxNs.store(0, std::memory_order_relaxed);
+}
+
+int64_t LatencyHistogram::percentileNs(double percentile) const {
+    uint64_t total = count();
+    if (total == 0) {
+        return 0;
+    }
+
+    // Rank of the sample to find, so that p100 is the largest one.
+    uint64_t target = total * percentile / 100.0;
+    if (target >= total) {
+        target = total - 1;
+    }
+    uint64_t seen = 0;
+
+    for (size_t i = 0; i < kBucketCount; i++) {
+        seen += mBuckets[i].load(std::memory_order_relaxed);
+        if (seen > target) {
+            return bucketUpperNs(i);
+        }
+    }
+    return bucketUpperNs(kBucketCount - 1);
+}
+
+std::string LatencyHistogram::dump(const std::string& name) const {
+    std::string out;
+    uint64_t total = count();
+
+    StringAppendF(&out, "%s: count=%llu", name.c_str(), static_cast<unsigned long long>(total));
+    if (total == 0) {
+        out += "\n";
+        return out;
+    }
+
+    StringAppendF(&out, " mean=%.1fus p50<%.1fus p95<%.1fus p99<%.1fus max=%.1fus\n",
+                  mSumNs.load(std::memory_order_relaxed) / 1000.0 / total,
+                  percentileNs(50) / 1000.0, percentileNs(95) / 1000.0,
+                  percentileNs(99) / 1000.0, mMaxNs.load(std::memory_order_relaxed) / 1000.0);
+
+    for (size_t i = 0; i < kBucketCount; i++) {
+        uint64_t n = mBuckets[i].load(std::memory_order_relaxed);
+        if (n != 0) {
+            StringAppendF(&out, "    <%.1fus: %llu\n", bucketUpperNs(i) / 1000.0,
+                          static_cast<unsigned long long>(n));
+        }
+    }
+    return out;
+}
+
+size_t LatencyHistogram::bucketFor(int64_t ns) {
+    size_t bucket = ns == 0 ? 0 : 64 - __builtin_clzll(ns);
+    return bucket < kBucketCount ? bucket : kBucketCount - 1;
+}
+
+int64_t LatencyHistogram::bucketUpperNs(size_t bucket) {
+    return 1LL << bucket;
+}
+
+}  // namespace sm8150
+}  // namespace meizu
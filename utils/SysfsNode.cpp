@@ -0,0 +1,130 @@
+/*
+ * Copyright (C) 2020 The MoKee Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "SysfsNode"
+
+#include "meizu/SysfsNode.h"
+
+#include <android-base/logging.h>
+#include <fcntl.h>
+#include <linux/magic.h>
+#include <sys/vfs.h>
+#include <unistd.h>
+
+namespace meizu {
+namespace sm8150 {
+
+namespace {
+
+/*
+ * Format value as decimal into buf, which must hold at least 11 bytes.
+ * Returns the number of characters written, without a terminator.
+ */
+size_t formatInt(char* buf, int32_t value) {
+    char tmp[11];
+    size_t len = 0;
+    uint32_t v = value < 0 ? -static_cast<uint32_t>(value) : value;
+
+    do {
+        tmp[len++] = '0' + (v % 10);
+        v /= 10;
+    } while (v != 0);
+
+    size_t pos = 0;
+    if (value < 0) {
+        buf[pos++] = '-';
+    }
+    while (len > 0) {
+        buf[pos++] = tmp[--len];
+    }
+    return pos;
+}
+
+}  // anonymous namespace
+
+SysfsNode::SysfsNode(const std::string& path)
+    : mPath(path),
+      mFd(-1),
+      mTruncate(false),
+      mCachedValue(0),
+      mCacheValid(false),
+      mCacheHits(0),
+      mCacheMisses(0) {}
+
+SysfsNode::~SysfsNode() {
+    close();
+}
+
+bool SysfsNode::write(int32_t value) {
+    if (mCacheValid.load(std::memory_order_relaxed) && mCachedValue == value) {
+        mCacheHits.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    mCacheMisses.fetch_add(1, std::memory_order_relaxed);
+    mCacheValid.store(false, std::memory_order_relaxed);
+
+    if (mFd < 0 && !open()) {
+        return false;
+    }
+
+    char buf[12];
+    size_t len = formatInt(buf, value);
+
+    ssize_t ret = TEMP_FAILURE_RETRY(pwrite(mFd, buf, len, 0));
+    if (ret != static_cast<ssize_t>(len)) {
+        PLOG(ERROR) << "Failed to write " << value << " to " << mPath;
+        close();
+        return false;
+    }
+
+    if (mTruncate && TEMP_FAILURE_RETRY(ftruncate(mFd, len)) < 0) {
+        PLOG(ERROR) << "Failed to truncate " << mPath;
+        close();
+        return false;
+    }
+
+    mCachedValue = value;
+    mCacheValid.store(true, std::memory_order_relaxed);
+    return true;
+}
+
+bool SysfsNode::exists() const {
+    return access(mPath.c_str(), W_OK) == 0;
+}
+
+bool SysfsNode::open() {
+    mFd = TEMP_FAILURE_RETRY(::open(mPath.c_str(), O_WRONLY | O_CLOEXEC));
+    if (mFd < 0) {
+        PLOG(ERROR) << "Failed to open " << mPath;
+        return false;
+    }
+
+    // sysfs takes each write as a whole value, anything else keeps the old tail.
+    struct statfs fs;
+    mTruncate = fstatfs(mFd, &fs) == 0 && fs.f_type != SYSFS_MAGIC;
+    return true;
+}
+
+void SysfsNode::close() {
+    if (mFd >= 0) {
+        ::close(mFd);
+        mFd = -1;
+    }
+}
+
+}  // namespace sm8150
+}  // namespace meizu
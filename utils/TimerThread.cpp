@@ -0,0 +1,152 @@
+/*
+ * Copyright (C) 2020 The MoKee Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "TimerThread"
+
+#include "meizu/TimerThread.h"
+
+#include <android-base/logging.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+namespace meizu {
+namespace sm8150 {
+
+static bool isAlarmClock(clockid_t clock) {
+    return clock == CLOCK_BOOTTIME_ALARM || clock == CLOCK_REALTIME_ALARM;
+}
+
+TimerThread::TimerThread(const char* name, Callback callback, clockid_t clock)
+    : mName(name),
+      mCallback(std::move(callback)),
+      mClock(clock),
+      mExit(false),
+      mEventFd(eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK)),
+      mTimerFd(timerfd_create(clock, TFD_CLOEXEC | TFD_NONBLOCK)),
+      mEpollFd(epoll_create1(EPOLL_CLOEXEC)) {
+    if (mEventFd < 0 || mTimerFd < 0 || mEpollFd < 0) {
+        PLOG(ERROR) << "Failed to create " << mName << " fds";
+        return;
+    }
+
+    struct epoll_event event = {};
+    event.events = EPOLLIN;
+    event.data.fd = mEventFd;
+    if (epoll_ctl(mEpollFd, EPOLL_CTL_ADD, mEventFd, &event) < 0) {
+        PLOG(ERROR) << "Failed to watch " << mName << " event";
+        return;
+    }
+
+    // Keeps the system awake from an alarm expiry until the next epoll_wait().
+    event.events = EPOLLIN | (isAlarmClock(clock) ? EPOLLWAKEUP : 0);
+    event.data.fd = mTimerFd;
+    if (epoll_ctl(mEpollFd, EPOLL_CTL_ADD, mTimerFd, &event) < 0) {
+        PLOG(ERROR) << "Failed to watch " << mName << " timer";
+        return;
+    }
+
+    mThread = std::thread(&TimerThread::threadLoop, this);
+}
+
+TimerThread::~TimerThread() {
+    stop();
+
+    for (int fd : {mEventFd, mTimerFd, mEpollFd}) {
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+}
+
+void TimerThread::wake() {
+    uint64_t one = 1;
+
+    if (write(mEventFd, &one, sizeof(one)) < 0) {
+        PLOG(ERROR) << "Failed to wake " << mName;
+    }
+}
+
+void TimerThread::stop() {
+    if (!mThread.joinable()) {
+        return;
+    }
+
+    mExit.store(true);
+    wake();
+    mThread.join();
+}
+
+int64_t TimerThread::now() const {
+    struct timespec ts;
+
+    // Alarm timers count on their base clock.
+    clockid_t clock = mClock;
+    if (clock == CLOCK_BOOTTIME_ALARM) {
+        clock = CLOCK_BOOTTIME;
+    } else if (clock == CLOCK_REALTIME_ALARM) {
+        clock = CLOCK_REALTIME;
+    }
+
+    clock_gettime(clock, &ts);
+    return ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+void TimerThread::arm(int64_t deadlineNs) {
+    struct itimerspec spec = {};
+
+    // A zero it_value disarms the timer, so never pass it for a real deadline.
+    spec.it_value.tv_sec = deadlineNs / 1000000000LL;
+    spec.it_value.tv_nsec = deadlineNs % 1000000000LL;
+    if (deadlineNs > 0 && spec.it_value.tv_sec == 0 && spec.it_value.tv_nsec == 0) {
+        spec.it_value.tv_nsec = 1;
+    }
+    if (timerfd_settime(mTimerFd, TFD_TIMER_ABSTIME, &spec, nullptr) < 0) {
+        PLOG(ERROR) << "Failed to arm " << mName << " timer";
+    }
+}
+
+void TimerThread::threadLoop() {
+    struct epoll_event events[2];
+
+    for (;;) {
+        int count = epoll_wait(mEpollFd, events, 2, -1);
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            PLOG(ERROR) << mName << " epoll_wait failed";
+            return;
+        }
+
+        for (int i = 0; i < count; i++) {
+            uint64_t value;
+            if (read(events[i].data.fd, &value, sizeof(value)) < 0 && errno != EAGAIN) {
+                PLOG(ERROR) << "Failed to read " << mName << " fd";
+            }
+        }
+
+        if (mExit.load()) {
+            return;
+        }
+
+        arm(mCallback());
+    }
+}
+
+}  // namespace sm8150
+}  // namespace meizu
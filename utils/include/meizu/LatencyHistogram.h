@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2020 The MoKee Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MEIZU_SM8150_LATENCYHISTOGRAM_H
+#define MEIZU_SM8150_LATENCYHISTOGRAM_H
+
+#include <stdint.h>
+#include <time.h>
+
+#include <array>
+#include <atomic>
+#include <string>
+
+namespace meizu {
+namespace sm8150 {
+
+static inline int64_t monotonicNs() {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+/*
+ * Lock-free histogram of durations with power-of-two buckets.
+ *
+ * Bucket 0 counts zero durations and bucket i counts durations in
+ * [2^(i-1), 2^i) ns. record() may be called from any thread.
+ */
+class LatencyHistogram {
+  public:
+    static constexpr size_t kBucketCount = 40;
+
+    LatencyHistogram();
+
+    void record(int64_t ns);
+    void reset();
+
+    uint64_t count() const { return mCount.load(std::memory_order_relaxed); }
+
+    // Upper bound of the bucket holding the given percentile (0-100), in ns.
+    int64_t percentileNs(double percentile) const;
+
+    // One summary line followed by the non-empty buckets.
+    std::string dump(const std::string& name) const;
+
+  private:
+    static size_t bucketFor(int64_t ns);
+    static int64_t bucketUpperNs(size_t bucket);
+
+    std::array<std::atomic<uint64_t>, kBucketCount> mBuckets;
+    std::atomic<uint64_t> mCount;
+    std::atomic<uint64_t> mSumNs;
+    std::atomic<int64_t> mMaxNs;
+};
+
+}  // namespace sm8150
+}  // namespace meizu
+
+#endif  // MEIZU_SM8150_LATENCYHISTOGRAM_H
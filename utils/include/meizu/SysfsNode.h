@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2020 The MoKee Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MEIZU_SM8150_SYSFSNODE_H
+#define MEIZU_SM8150_SYSFSNODE_H
+
+#include <stdint.h>
+
+#include <atomic>
+#include <string>
+
+namespace meizu {
+namespace sm8150 {
+
+/*
+ * A writable sysfs attribute that keeps its fd open between writes.
+ *
+ * Values are formatted into a stack buffer and written with pwrite()
+ * at offset 0, so a write costs a single syscall. The node is opened
+ * lazily and reopened after a failed write. A node that is a regular
+ * file rather than a sysfs attribute, such as a fake tree in a test, is
+ * also truncated after each write so that no stale digits remain.
+ *
+ * The last value written is shadowed, and writing the same value again
+ * is skipped until the cache is invalidated, e.g. after the driver may
+ * have reset its state. write() is not thread-safe and callers serialize
+ * access to a node; invalidate() and the counters may be used from any
+ * thread.
+ */
+class SysfsNode {
+  public:
+    explicit SysfsNode(const std::string& path);
+    ~SysfsNode();
+
+    SysfsNode(const SysfsNode&) = delete;
+    SysfsNode& operator=(const SysfsNode&) = delete;
+
+    bool write(int32_t value);
+    void invalidate() { mCacheValid.store(false, std::memory_order_relaxed); }
+
+    bool exists() const;
+    const std::string& path() const { return mPath; }
+
+    // Writes skipped because the value was already cached, and writes that reached sysfs.
+    uint64_t cacheHits() const { return mCacheHits.load(std::memory_order_relaxed); }
+    uint64_t cacheMisses() const { return mCacheMisses.load(std::memory_order_relaxed); }
+
+  private:
+    bool open();
+    void close();
+
+    std::string mPath;
+    int mFd;
+    bool mTruncate;
+
+    int32_t mCachedValue;
+    std::atomic<bool> mCacheValid;
+    std::atomic<uint64_t> mCacheHits;
+    std::atomic<uint64_t> mCacheMisses;
+};
+
+}  // namespace sm8150
+}  // namespace meizu
+
+#endif  // MEIZU_SM8150_SYSFSNODE_H
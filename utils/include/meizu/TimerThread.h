@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2020 The MoKee Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MEIZU_SM8150_TIMERTHREAD_H
+#define MEIZU_SM8150_TIMERTHREAD_H
+
+#include <stdint.h>
+#include <time.h>
+
+#include <atomic>
+#include <functional>
+#include <thread>
+
+namespace meizu {
+namespace sm8150 {
+
+/*
+ * A thread that sleeps on a timerfd until a deadline passes or it is woken.
+ *
+ * The callback runs on the thread after every wake() and every expiry, and
+ * returns the next absolute deadline on the thread's clock, or 0 to disarm
+ * the timer. Owners keep their own state under their own lock; the callback
+ * is called without any lock held.
+ *
+ * With an alarm clock the timer also fires in suspend, and the thread holds
+ * a wakeup source from the expiry until the callback has returned. Alarm
+ * timers need CAP_WAKE_ALARM, without it valid() is false. The wakeup
+ * source needs CAP_BLOCK_SUSPEND.
+ */
+class TimerThread {
+  public:
+    using Callback = std::function<int64_t()>;
+
+    TimerThread(const char* name, Callback callback, clockid_t clock = CLOCK_MONOTONIC);
+    ~TimerThread();
+
+    TimerThread(const TimerThread&) = delete;
+    TimerThread& operator=(const TimerThread&) = delete;
+
+    // False if the thread could not be started.
+    bool valid() const { return mThread.joinable(); }
+
+    // Run the callback as soon as possible.
+    void wake();
+
+    // Join the thread. The callback never runs once this returns. Must not
+    // be called from the callback.
+    void stop();
+
+    int64_t now() const;
+
+  private:
+    void threadLoop();
+    void arm(int64_t deadlineNs);
+
+    const char* mName;
+    Callback mCallback;
+    clockid_t mClock;
+
+    std::atomic<bool> mExit;
+    int mEventFd;
+    int mTimerFd;
+    int mEpollFd;
+    std::thread mThread;
+};
+
+}  // namespace sm8150
+}  // namespace meizu
+
+#endif  // MEIZU_SM8150_TIMERTHREAD_H
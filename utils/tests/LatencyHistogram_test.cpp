@@ -0,0 +1,131 @@
+/*
+ * Copyright (C) 2020 The MoKee Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <meizu/LatencyHistogram.h>
+
+#include <thread>
+#include <vector>
+
+using meizu::sm8150::LatencyHistogram;
+
+namespace {
+
+TEST(LatencyHistogramTest, EmptyHistogram) {
+    LatencyHistogram histogram;
+
+    EXPECT_EQ(0u, histogram.count());
+    EXPECT_EQ(0, histogram.percentileNs(50));
+    EXPECT_EQ("empty: count=0\n", histogram.dump("empty"));
+}
+
+TEST(LatencyHistogramTest, PercentileIsUpperBoundOfPowerOfTwoBucket) {
+    LatencyHistogram histogram;
+
+    // Bucket i holds [2^(i-1), 2^i) ns.
+    histogram.record(1000);
+    EXPECT_EQ(1024, histogram.percentileNs(50));
+
+    histogram.reset();
+    histogram.record(1024);
+    EXPECT_EQ(2048, histogram.percentileNs(50));
+
+    histogram.reset();
+    histogram.record(0);
+    EXPECT_EQ(1, histogram.percentileNs(50));
+}
+
+TEST(LatencyHistogramTest, SyntheticUniformTimings) {
+    LatencyHistogram histogram;
+
+    // 1us to 1000us in 1us steps.
+    for (int64_t us = 1; us <= 1000; us++) {
+        histogram.record(us * 1000);
+    }
+
+    ASSERT_EQ(1000u, histogram.count());
+
+    // Power-of-two buckets bound each percentile within a factor of two.
+    for (double percentile : {50.0, 95.0, 99.0}) {
+        int64_t expectedNs = percentile * 10 * 1000;
+        int64_t ns = histogram.percentileNs(percentile);
+        EXPECT_GE(ns, expectedNs) << "p" << percentile;
+        EXPECT_LT(ns, 2 * expectedNs) << "p" << percentile;
+    }
+
+    std::string dump = histogram.dump("uniform");
+    EXPECT_NE(std::string::npos, dump.find("uniform: count=1000 mean=500.5us")) << dump;
+    EXPECT_NE(std::string::npos, dump.find("max=1000.0us")) << dump;
+}
+
+TEST(LatencyHistogramTest, SyntheticBimodalTail) {
+    LatencyHistogram histogram;
+
+    // 98 fast writes and 2 that stall for a frame.
+    for (int i = 0; i < 98; i++) {
+        histogram.record(20 * 1000);
+    }
+    histogram.record(16 * 1000 * 1000);
+    histogram.record(17 * 1000 * 1000);
+
+    EXPECT_LT(histogram.percentileNs(50), 40 * 1000);
+    EXPECT_LT(histogram.percentileNs(95), 40 * 1000);
+    EXPECT_GE(histogram.percentileNs(99), 16 * 1000 * 1000);
+}
+
+TEST(LatencyHistogramTest, OutOfRangeTimingsAreClamped) {
+    LatencyHistogram histogram;
+
+    histogram.record(-5);
+    EXPECT_EQ(1, histogram.percentileNs(100));
+
+    histogram.reset();
+    histogram.record(INT64_MAX);
+    EXPECT_EQ(1LL << (LatencyHistogram::kBucketCount - 1), histogram.percentileNs(50));
+}
+
+TEST(LatencyHistogramTest, ResetClearsEverything) {
+    LatencyHistogram histogram;
+
+    histogram.record(123456);
+    histogram.reset();
+
+    EXPECT_EQ(0u, histogram.count());
+    EXPECT_EQ("h: count=0\n", histogram.dump("h"));
+}
+
+TEST(LatencyHistogramTest, ConcurrentRecording) {
+    constexpr int kThreads = 4;
+    constexpr int kPerThread = 100000;
+    LatencyHistogram histogram;
+    std::vector<std::thread> threads;
+
+    for (int t = 0; t < kThreads; t++) {
+        threads.emplace_back([&histogram, t] {
+            for (int i = 0; i < kPerThread; i++) {
+                histogram.record((t + 1) * 1000);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(static_cast<uint64_t>(kThreads * kPerThread), histogram.count());
+    EXPECT_NE(std::string::npos, histogram.dump("c").find("max=4.0us"));
+}
+
+}  // anonymous namespace
@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2020 The MoKee Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+#include <meizu/ScratchSysfs.h>
+#include <meizu/SysfsNode.h>
+
+#include <fstream>
+
+using meizu::sm8150::ScratchSysfs;
+using meizu::sm8150::SysfsNode;
+
+namespace {
+
+constexpr const char* kNode = "/sys/class/backlight/panel0-backlight/brightness";
+
+/*
+ * Writes per second to a node in a scratch directory, alternating between
+ * two values. BM_ofstreamWrite opens a stream per write as the Light HAL
+ * used to, BM_sysfsNodeWrite keeps the fd open.
+ */
+void BM_ofstreamWrite(benchmark::State& state) {
+    ScratchSysfs sysfs;
+    std::string path = sysfs.path(kNode);
+    int32_t i = 0;
+
+    sysfs.create(kNode, "0");
+    for (auto _ : state) {
+        std::ofstream file(path);
+        file << (i++ & 1 ? 255 : 0);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_ofstreamWrite);
+
+void BM_sysfsNodeWrite(benchmark::State& state) {
+    ScratchSysfs sysfs;
+    int32_t i = 0;
+
+    sysfs.create(kNode, "0");
+    SysfsNode node(sysfs.path(kNode));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(node.write(i++ & 1 ? 255 : 0));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_sysfsNodeWrite);
+
+}  // anonymous namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2020 The MoKee Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MEIZU_SM8150_SCRATCHSYSFS_H
+#define MEIZU_SM8150_SCRATCHSYSFS_H
+
+#include <android-base/file.h>
+#include <android-base/strings.h>
+#include <android-base/test_utils.h>
+#include <sys/stat.h>
+
+#include <string>
+
+namespace meizu {
+namespace sm8150 {
+
+/*
+ * A scratch directory standing in for the root of sysfs, for running HAL
+ * code off-device through its configurable sysfs root. Nodes are regular
+ * files and go away with the directory.
+ */
+class ScratchSysfs {
+  public:
+    // To be prepended to every sysfs path.
+    std::string root() const { return mDir.path; }
+
+    // Where a sysfs path lives in the scratch directory.
+    std::string path(const std::string& path) const { return mDir.path + path; }
+
+    // Creates the node along with every missing parent directory.
+    void create(const std::string& path, const std::string& content) {
+        for (size_t pos = path.find('/', 1); pos != std::string::npos;
+             pos = path.find('/', pos + 1)) {
+            mkdir(this->path(path.substr(0, pos)).c_str(), 0755);
+        }
+        write(path, content);
+    }
+
+    void write(const std::string& path, const std::string& content) {
+        android::base::WriteStringToFile(content, this->path(path));
+    }
+
+    // The node's content without surrounding whitespace, empty if it is missing.
+    std::string read(const std::string& path) const {
+        std::string content;
+
+        android::base::ReadFileToString(this->path(path), &content);
+        return android::base::Trim(content);
+    }
+
+  private:
+    TemporaryDir mDir;
+};
+
+}  // namespace sm8150
+}  // namespace meizu
+
+#endif  // MEIZU_SM8150_SCRATCHSYSFS_H
@@ -0,0 +1,75 @@
+/*
+ * Copyright (C) 2020 The MoKee Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "VibratorService"
+
+#include <meizu/LatencyHistogram.h>
+
+#include "CompletionNotifier.h"
+
+namespace meizu {
+namespace sm8150 {
+
+CompletionNotifier::CompletionNotifier()
+    : mDeadlineNs(0), mThread("completion notifier", [this] { return runDue(); }) {}
+
+CompletionNotifier::~CompletionNotifier() {
+    mThread.stop();
+}
+
+void CompletionNotifier::schedule(uint32_t delayMs, std::function<void()> callback) {
+    std::lock_guard<std::mutex> lock(mLock);
+
+    mCallback = std::move(callback);
+    mDeadlineNs = monotonicNs() + delayMs * 1000000LL;
+    mThread.wake();
+}
+
+void CompletionNotifier::cancel() {
+    std::lock_guard<std::mutex> lock(mLock);
+
+    if (!mCallback) {
+        return;
+    }
+
+    mCallback = nullptr;
+    mThread.wake();
+}
+
+/*
+ * Runs the pending callback once it is due. Returns its deadline while it
+ * is not, or 0 when nothing is pending.
+ */
+int64_t CompletionNotifier::runDue() {
+    std::function<void()> due;
+
+    std::unique_lock<std::mutex> lock(mLock);
+    if (!mCallback) {
+        return 0;
+    }
+    if (mDeadlineNs > monotonicNs()) {
+        return mDeadlineNs;
+    }
+    due = std::move(mCallback);
+    mCallback = nullptr;
+    lock.unlock();
+
+    due();
+    return 0;
+}
+
+}  // namespace sm8150
+}  // namespace meizu
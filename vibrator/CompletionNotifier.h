@@ -0,0 +1,54 @@
+/*
+ * Copyright (C) 2020 The MoKee Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MEIZU_SM8150_VIBRATOR_COMPLETIONNOTIFIER_H
+#define MEIZU_SM8150_VIBRATOR_COMPLETIONNOTIFIER_H
+
+#include <functional>
+#include <meizu/TimerThread.h>
+#include <mutex>
+
+namespace meizu {
+namespace sm8150 {
+
+/*
+ * Runs a callback once the vibration in progress is expected to end.
+ *
+ * Only one vibration plays at a time, so only one callback is kept: a new
+ * schedule() or a cancel() drops the pending one without running it.
+ * Callbacks run on the notifier thread, outside of its lock.
+ */
+class CompletionNotifier {
+  public:
+    CompletionNotifier();
+    ~CompletionNotifier();
+
+    void schedule(uint32_t delayMs, std::function<void()> callback);
+    void cancel();
+
+  private:
+    int64_t runDue();
+
+    std::mutex mLock;
+    std::function<void()> mCallback;
+    int64_t mDeadlineNs;
+
+    TimerThread mThread;
+};
+
+}  // namespace sm8150
+}  // namespace meizu
+
+#endif  // MEIZU_SM8150_VIBRATOR_COMPLETIONNOTIFIER_H
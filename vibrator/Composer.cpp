@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2020 The MoKee Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "VibratorService"
+
+#include <android-base/logging.h>
+#include <cmath>
+#include <meizu/LatencyHistogram.h>
+
+#include "Composer.h"
+
+namespace meizu {
+namespace sm8150 {
+
+uint8_t Composer::strengthForScale(float scale) {
+    return std::lround(scale * UINT8_MAX);
+}
+
+Composer::Composer(vibrator_device_t *device)
+    : mDevice(device),
+      mNext(0),
+      mStartNs(0),
+      mErrors(0),
+      mThread("composer", [this] { return playDueSteps(); }) {}
+
+Composer::~Composer() {
+    mThread.stop();
+}
+
+void Composer::start(std::vector<ComposeStep> steps) {
+    std::lock_guard<std::mutex> lock(mLock);
+
+    mSteps = std::move(steps);
+    mNext = 0;
+    mStartNs = monotonicNs();
+    mThread.wake();
+}
+
+void Composer::cancel() {
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+
+        if (mNext < mSteps.size()) {
+            mSteps.clear();
+            mNext = 0;
+            mThread.wake();
+        }
+    }
+
+    // The last steps may have been taken but still be playing.
+    std::lock_guard<std::mutex> lock(mPlayLock);
+}
+
+/*
+ * Collect every step that is due, and find when the next one is, or 0
+ * once the composition is done.
+ */
+std::vector<ComposeStep> Composer::takeDueStepsLocked(int64_t *nextNs) {
+    std::vector<ComposeStep> due;
+    int64_t now = monotonicNs();
+
+    while (mNext < mSteps.size()) {
+        const ComposeStep &step = mSteps[mNext];
+        int64_t dueNs = mStartNs + step.offsetMs * 1000000LL;
+
+        if (dueNs > now) {
+            *nextNs = dueNs;
+            return due;
+        }
+
+        if (step.id != 0) {
+            due.push_back(step);
+        }
+        mNext++;
+    }
+
+    *nextNs = 0;
+    return due;
+}
+
+int64_t Composer::playDueSteps() {
+    std::lock_guard<std::mutex> playLock(mPlayLock);
+    int64_t nextNs;
+
+    std::unique_lock<std::mutex> lock(mLock);
+    std::vector<ComposeStep> due = takeDueStepsLocked(&nextNs);
+    lock.unlock();
+
+    // Outside mLock, so that a slow driver does not block start().
+    for (const auto &step : due) {
+        int32_t ret = mDevice->vibrator_perform_effect(mDevice, step.id, step.strength);
+        if (ret != 0) {
+            mErrors.fetch_add(1, std::memory_order_relaxed);
+            LOG(ERROR) << "Compose: command failed: " << strerror(-ret);
+        }
+    }
+
+    return nextNs;
+}
+
+}  // namespace sm8150
+}  // namespace meizu
@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2020 The MoKee Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MEIZU_SM8150_VIBRATOR_COMPOSER_H
+#define MEIZU_SM8150_VIBRATOR_COMPOSER_H
+
+#include <atomic>
+#include <meizu/TimerThread.h>
+#include <mutex>
+#include <vector>
+
+#include "hardware/vibrator.h"
+
+namespace meizu {
+namespace sm8150 {
+
+struct ComposeStep {
+    // When the step fires, relative to the start of the composition.
+    uint32_t offsetMs;
+    // Meizu effect id, 0 for a pause.
+    uint32_t id;
+    uint8_t strength;
+};
+
+/*
+ * Plays a composition of Meizu effects on its own thread.
+ *
+ * The thread sleeps until the next step is due, so a composition costs one
+ * wakeup per step.
+ */
+class Composer {
+  public:
+    // Limits on compositions accepted from the framework.
+    static constexpr uint32_t kDelayMaxMs = 1000;
+    static constexpr size_t kSizeMax = 16;
+
+    // Maps a primitive scale in [0, 1] to a Meizu strength byte.
+    static uint8_t strengthForScale(float scale);
+
+    explicit Composer(vibrator_device_t *device);
+    ~Composer();
+
+    // Replaces the composition in progress, if any.
+    void start(std::vector<ComposeStep> steps);
+    // Once this returns no step is playing and none will be until the next start().
+    void cancel();
+
+    uint64_t errors() const { return mErrors.load(std::memory_order_relaxed); }
+    void resetStats() { mErrors.store(0, std::memory_order_relaxed); }
+
+  private:
+    int64_t playDueSteps();
+    std::vector<ComposeStep> takeDueStepsLocked(int64_t *nextNs);
+
+    vibrator_device_t *mDevice;
+
+    // Held by the thread while it takes and plays due steps.
+    std::mutex mPlayLock;
+
+    std::mutex mLock;
+    std::vector<ComposeStep> mSteps;
+    size_t mNext;
+    int64_t mStartNs;
+
+    std::atomic<uint64_t> mErrors;
+
+    TimerThread mThread;
+};
+
+}  // namespace sm8150
+}  // namespace meizu
+
+#endif  // MEIZU_SM8150_VIBRATOR_COMPOSER_H
@@ -0,0 +1,219 @@
+/*
+ * Copyright (C) 2020 The MoKee Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "VibratorService"
+
+#include <android-base/logging.h>
+#include <android-base/stringprintf.h>
+#include <pthread.h>
+#include <sched.h>
+
+#include "EffectQueue.h"
+
+using android::base::StringAppendF;
+
+namespace meizu {
+namespace sm8150 {
+
+// An effect this late is not worth playing if newer ones are waiting.
+static constexpr int64_t kMaxQueueDelayNs = 50 * 1000000LL;
+
+// Slot encoding of an effect: id in bits 0-31, strength in 32-39, warm-up in 40.
+static constexpr uint64_t kWarmUpBit = 1ULL << 40;
+
+EffectQueue::EffectQueue(vibrator_device_t *device)
+    : mDevice(device),
+      mHead(0),
+      mTail(0),
+      mFlushed(0),
+      mMaxDepth(0),
+      mDrops(0),
+      mErrors(0),
+      mFirstCallNs(-1),
+      mExit(false) {
+    mThread = std::thread(&EffectQueue::threadLoop, this);
+}
+
+EffectQueue::~EffectQueue() {
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+        mExit = true;
+    }
+    mCond.notify_one();
+    mThread.join();
+}
+
+void EffectQueue::push(uint32_t id, uint8_t strength) {
+    pushEntry({id, strength, monotonicNs(), false});
+}
+
+void EffectQueue::warmUp(uint32_t id) {
+    pushEntry({id, 0, monotonicNs(), true});
+}
+
+void EffectQueue::pushEntry(const Entry &entry) {
+    size_t head = mHead.load(std::memory_order_relaxed);
+    size_t tail = mTail.load(std::memory_order_acquire);
+
+    if (head - tail >= kCapacity) {
+        // Either this evicts the oldest entry or the worker just took it,
+        // and both free the slot. On failure tail is reloaded.
+        if (mTail.compare_exchange_strong(tail, tail + 1, std::memory_order_acq_rel)) {
+            mDrops.fetch_add(1, std::memory_order_relaxed);
+            tail++;
+        }
+    }
+
+    Slot &slot = mRing[head % kCapacity];
+    slot.effect.store(entry.id | static_cast<uint64_t>(entry.strength) << 32 |
+                              (entry.warmUp ? kWarmUpBit : 0),
+                      std::memory_order_relaxed);
+    slot.queuedNs.store(entry.queuedNs, std::memory_order_relaxed);
+    mHead.store(head + 1, std::memory_order_release);
+
+    size_t depth = head + 1 - tail;
+    if (depth > mMaxDepth.load(std::memory_order_relaxed)) {
+        mMaxDepth.store(depth, std::memory_order_relaxed);
+    }
+
+    // Taking the lock orders this wakeup against the worker's predicate check.
+    { std::lock_guard<std::mutex> lock(mLock); }
+    mCond.notify_one();
+}
+
+void EffectQueue::flush() {
+    mFlushed.store(mHead.load(std::memory_order_relaxed), std::memory_order_release);
+
+    // The worker checks mFlushed under this lock, so anything it plays from
+    // here on was pushed after the flush.
+    std::lock_guard<std::mutex> lock(mPlayLock);
+}
+
+bool EffectQueue::setRealtimePriority(int priority) {
+    struct sched_param param = {};
+
+    param.sched_priority = priority;
+    int ret = pthread_setschedparam(mThread.native_handle(), SCHED_FIFO, &param);
+    if (ret != 0) {
+        LOG(ERROR) << "Failed to set effect worker priority: " << strerror(ret);
+        return false;
+    }
+    return true;
+}
+
+void EffectQueue::resetStats() {
+    mMaxDepth.store(depth(), std::memory_order_relaxed);
+    mDrops.store(0, std::memory_order_relaxed);
+    mErrors.store(0, std::memory_order_relaxed);
+    mSteadyLatency.reset();
+}
+
+std::string EffectQueue::dump() const {
+    std::string out = mSteadyLatency.dump("driver perform");
+
+    if (firstCallNs() >= 0) {
+        StringAppendF(&out, "driver first perform=%.1fus\n", firstCallNs() / 1000.0);
+    }
+    StringAppendF(&out, "effect queue depth=%zu maxDepth=%zu drops=%llu errors=%llu\n", depth(),
+                  maxDepth(), static_cast<unsigned long long>(drops()),
+                  static_cast<unsigned long long>(errors()));
+    return out;
+}
+
+size_t EffectQueue::depth() const {
+    return mHead.load(std::memory_order_relaxed) - mTail.load(std::memory_order_relaxed);
+}
+
+/*
+ * Claim the oldest entry. Returns false if the ring is empty.
+ */
+bool EffectQueue::popEntry(size_t *index, Entry *entry) {
+    size_t tail = mTail.load(std::memory_order_acquire);
+
+    for (;;) {
+        if (tail == mHead.load(std::memory_order_acquire)) {
+            return false;
+        }
+
+        const Slot &slot = mRing[tail % kCapacity];
+        uint64_t effect = slot.effect.load(std::memory_order_relaxed);
+        int64_t queuedNs = slot.queuedNs.load(std::memory_order_relaxed);
+
+        // Fails if the producer evicted this entry, and maybe reused its slot.
+        if (mTail.compare_exchange_weak(tail, tail + 1, std::memory_order_acq_rel)) {
+            *index = tail;
+            entry->id = static_cast<uint32_t>(effect);
+            entry->strength = static_cast<uint8_t>(effect >> 32);
+            entry->warmUp = (effect & kWarmUpBit) != 0;
+            entry->queuedNs = queuedNs;
+            return true;
+        }
+    }
+}
+
+void EffectQueue::play(const Entry &entry) {
+    int64_t startNs = monotonicNs();
+    int32_t ret = mDevice->vibrator_perform_effect(mDevice, entry.id, entry.strength);
+    int64_t callNs = monotonicNs() - startNs;
+
+    if (mFirstCallNs.load(std::memory_order_relaxed) < 0) {
+        mFirstCallNs.store(callNs, std::memory_order_relaxed);
+        LOG(INFO) << (entry.warmUp ? "Warm-up" : "First effect") << " took " << callNs << " ns";
+    } else {
+        mSteadyLatency.record(callNs);
+    }
+
+    if (ret != 0) {
+        mErrors.fetch_add(1, std::memory_order_relaxed);
+        LOG(ERROR) << "Perform: command failed: " << strerror(-ret);
+    }
+}
+
+void EffectQueue::threadLoop() {
+    for (;;) {
+        size_t index;
+        Entry entry;
+
+        if (!popEntry(&index, &entry)) {
+            size_t tail = mTail.load(std::memory_order_relaxed);
+            std::unique_lock<std::mutex> lock(mLock);
+            mCond.wait(lock, [&] {
+                return mExit || mHead.load(std::memory_order_acquire) != tail;
+            });
+            if (mExit) {
+                return;
+            }
+            continue;
+        }
+
+        bool superseded = index + 1 < mHead.load(std::memory_order_acquire) &&
+                          monotonicNs() - entry.queuedNs > kMaxQueueDelayNs;
+        if (superseded) {
+            mDrops.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+
+        std::lock_guard<std::mutex> lock(mPlayLock);
+        if (index < mFlushed.load(std::memory_order_acquire)) {
+            mDrops.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+        play(entry);
+    }
+}
+
+}  // namespace sm8150
+}  // namespace meizu
@@ -0,0 +1,132 @@
+/*
+ * Copyright (C) 2020 The MoKee Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MEIZU_SM8150_VIBRATOR_EFFECTQUEUE_H
+#define MEIZU_SM8150_VIBRATOR_EFFECTQUEUE_H
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <meizu/LatencyHistogram.h>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "hardware/vibrator.h"
+
+namespace meizu {
+namespace sm8150 {
+
+/*
+ * Plays effects on a worker thread so that callers never wait for the driver.
+ *
+ * A bounded single-producer/single-consumer ring carries effects from the
+ * binder thread to the worker. When the ring is full, the oldest pending
+ * effect is evicted to make room, so the newest request is always played.
+ * When the worker falls behind, an effect that has already waited too long
+ * and has newer effects queued behind it is superseded and dropped as well.
+ * push(), warmUp() and flush() must be called from a single producer thread.
+ *
+ * The first driver call after boot pays for faulting in the vendor library
+ * and the sysfs path, so its latency is kept apart from the steady state.
+ */
+class EffectQueue {
+  public:
+    static constexpr size_t kCapacity = 8;
+
+    explicit EffectQueue(vibrator_device_t *device);
+    ~EffectQueue();
+
+    // Evicts the oldest pending effect if the ring is full.
+    void push(uint32_t id, uint8_t strength);
+
+    // Queue a zero-strength effect to take the cold-start cost off the first
+    // real effect.
+    void warmUp(uint32_t id);
+
+    // Drop every queued effect that has not been handed to the driver yet,
+    // and wait for the one in flight, if any. The driver is free once this
+    // returns.
+    void flush();
+
+    // Move the worker to SCHED_FIFO at the given priority.
+    bool setRealtimePriority(int priority);
+
+    size_t depth() const;
+    size_t maxDepth() const { return mMaxDepth.load(std::memory_order_relaxed); }
+    uint64_t drops() const { return mDrops.load(std::memory_order_relaxed); }
+    uint64_t errors() const { return mErrors.load(std::memory_order_relaxed); }
+
+    // Latency of the first driver call, or -1 if none was made yet.
+    int64_t firstCallNs() const { return mFirstCallNs.load(std::memory_order_relaxed); }
+    // Latency of every driver call after the first one.
+    const LatencyHistogram &steadyLatency() const { return mSteadyLatency; }
+
+    // Clears every counter except the first call latency.
+    void resetStats();
+    std::string dump() const;
+
+  private:
+    struct Entry {
+        uint32_t id;
+        uint8_t strength;
+        int64_t queuedNs;
+        bool warmUp;
+    };
+
+    // The producer may overwrite a slot while the worker reads it, so slots
+    // are atomics and the worker only trusts what it read once it has
+    // claimed the index.
+    struct Slot {
+        std::atomic<uint64_t> effect;
+        std::atomic<int64_t> queuedNs;
+    };
+
+    void pushEntry(const Entry &entry);
+    bool popEntry(size_t *index, Entry *entry);
+    void play(const Entry &entry);
+    void threadLoop();
+
+    vibrator_device_t *mDevice;
+
+    std::array<Slot, kCapacity> mRing;
+    // Monotonic indices; the slot of index i is i % kCapacity. The worker
+    // advances mTail to consume an entry, the producer to evict one.
+    std::atomic<size_t> mHead;
+    std::atomic<size_t> mTail;
+    // Entries below this index were flushed by the producer.
+    std::atomic<size_t> mFlushed;
+
+    std::atomic<size_t> mMaxDepth;
+    std::atomic<uint64_t> mDrops;
+    std::atomic<uint64_t> mErrors;
+
+    std::atomic<int64_t> mFirstCallNs;
+    LatencyHistogram mSteadyLatency;
+
+    // Held by the worker from the flushed check until the driver returns.
+    std::mutex mPlayLock;
+
+    std::mutex mLock;
+    std::condition_variable mCond;
+    bool mExit;
+
+    std::thread mThread;
+};
+
+}  // namespace sm8150
+}  // namespace meizu
+
+#endif  // MEIZU_SM8150_VIBRATOR_EFFECTQUEUE_H
@@ -0,0 +1,178 @@
+/*
+ * Copyright (C) 2020 The MoKee Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "VibratorService"
+
+#include <android-base/file.h>
+#include <android-base/logging.h>
+#include <android-base/strings.h>
+
+#include <sstream>
+
+#include "EffectTable.h"
+
+using android::base::ReadFileToString;
+using android::base::Split;
+
+namespace meizu {
+namespace sm8150 {
+
+static constexpr const char *kEffectNames[EffectTable::kEffectCount] = {
+        "CLICK",       "DOUBLE_CLICK", "TICK",        "THUD",        "POP",
+        "HEAVY_CLICK", "RINGTONE_1",   "RINGTONE_2",  "RINGTONE_3",  "RINGTONE_4",
+        "RINGTONE_5",  "RINGTONE_6",   "RINGTONE_7",  "RINGTONE_8",  "RINGTONE_9",
+        "RINGTONE_10", "RINGTONE_11",  "RINGTONE_12", "RINGTONE_13", "RINGTONE_14",
+        "RINGTONE_15", "TEXTURE_TICK",
+};
+
+static constexpr const char *kPrimitiveNames[EffectTable::kPrimitiveCount] = {
+        "NOOP",       "CLICK",     "THUD",       "SPIN",
+        "QUICK_RISE", "SLOW_RISE", "QUICK_FALL", "LIGHT_TICK",
+};
+
+static constexpr const char *kStrengthNames[EffectTable::kStrengthCount] = {
+        "LIGHT",
+        "MEDIUM",
+        "STRONG",
+};
+
+/*
+ * Meizu effect ids and how long each one plays. The durations are estimates
+ * for the Meizu haptics driver. The framework turns the motor off once the
+ * reported duration has passed, so measured values from the config file
+ * take precedence.
+ */
+static constexpr std::array<EffectInfo, EffectTable::kEffectCount> kDefaultEffects = {{
+        {31008, 20},   // CLICK
+        {31003, 110},  // DOUBLE_CLICK
+        {21000, 10},   // TICK
+        {30900, 50},   // THUD
+        {22520, 15},   // POP
+        {30900, 50},   // HEAVY_CLICK
+}};
+
+static constexpr std::array<uint8_t, EffectTable::kStrengthCount> kDefaultStrengths = {{
+        50,   // LIGHT
+        120,  // MEDIUM
+        255,  // STRONG
+}};
+
+static constexpr std::array<EffectInfo, EffectTable::kPrimitiveCount> kDefaultPrimitives = {{
+        {0, 0},       // NOOP
+        {31008, 20},  // CLICK
+        {30900, 50},  // THUD
+        {0, 0},       // SPIN
+        {0, 0},       // QUICK_RISE
+        {0, 0},       // SLOW_RISE
+        {0, 0},       // QUICK_FALL
+        {21000, 10},  // LIGHT_TICK
+}};
+
+template <size_t N>
+static bool indexOf(const char *const (&names)[N], const std::string &name, size_t *index) {
+    for (size_t i = 0; i < N; i++) {
+        if (name == names[i]) {
+            *index = i;
+            return true;
+        }
+    }
+    return false;
+}
+
+EffectTable::EffectTable()
+    : mEffects(kDefaultEffects), mStrengths(kDefaultStrengths), mPrimitives(kDefaultPrimitives) {
+    for (auto &strengths : mEffectStrengths) {
+        strengths.fill(kDefaultStrength);
+    }
+}
+
+bool EffectTable::load(const std::string &path) {
+    std::string content;
+
+    if (!ReadFileToString(path, &content)) {
+        return false;
+    }
+
+    for (const auto &line : Split(content, "\n")) {
+        std::istringstream entry(line);
+        std::string kind, name;
+        size_t index;
+
+        if (!(entry >> kind >> name) || kind[0] == '#') {
+            continue;
+        }
+
+        if (kind == "effect" && indexOf(kEffectNames, name, &index)) {
+            EffectInfo info;
+            if (entry >> info.id >> info.durationMs) {
+                mEffects[index] = info;
+                continue;
+            }
+        } else if (kind == "primitive" && indexOf(kPrimitiveNames, name, &index)) {
+            EffectInfo info;
+            if (entry >> info.id >> info.durationMs) {
+                mPrimitives[index] = info;
+                continue;
+            }
+        } else if (kind == "strength" && indexOf(kStrengthNames, name, &index)) {
+            uint32_t value;
+            if (entry >> value && value <= UINT8_MAX) {
+                mStrengths[index] = value;
+                continue;
+            }
+        } else if (kind == "effect_strength" && indexOf(kEffectNames, name, &index)) {
+            std::string strengthName;
+            size_t strength;
+            uint32_t value;
+            if (entry >> strengthName >> value && value <= UINT8_MAX &&
+                indexOf(kStrengthNames, strengthName, &strength)) {
+                mEffectStrengths[index][strength] = value;
+                continue;
+            }
+        }
+
+        LOG(WARNING) << path << ": skipping invalid line: " << line;
+    }
+
+    return true;
+}
+
+const EffectInfo *EffectTable::effect(uint32_t effect) const {
+    if (effect >= mEffects.size() || mEffects[effect].id == 0) {
+        return nullptr;
+    }
+    return &mEffects[effect];
+}
+
+const EffectInfo *EffectTable::primitive(uint32_t primitive) const {
+    if (primitive >= mPrimitives.size() || (primitive != 0 && mPrimitives[primitive].id == 0)) {
+        return nullptr;
+    }
+    return &mPrimitives[primitive];
+}
+
+bool EffectTable::strength(uint32_t effect, uint32_t strength, uint8_t *value) const {
+    if (effect >= mEffectStrengths.size() || strength >= mStrengths.size()) {
+        return false;
+    }
+
+    int16_t byte = mEffectStrengths[effect][strength];
+    *value = byte == kDefaultStrength ? mStrengths[strength] : byte;
+    return true;
+}
+
+}  // namespace sm8150
+}  // namespace meizu
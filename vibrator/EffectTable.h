@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2020 The MoKee Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MEIZU_SM8150_VIBRATOR_EFFECTTABLE_H
+#define MEIZU_SM8150_VIBRATOR_EFFECTTABLE_H
+
+#include <stdint.h>
+
+#include <array>
+#include <string>
+
+namespace meizu {
+namespace sm8150 {
+
+struct EffectInfo {
+    // Meizu effect id passed to vibrator_perform_effect, 0 if unsupported.
+    uint32_t id;
+    // How long the effect plays, reported back to the framework.
+    uint32_t durationMs;
+};
+
+/*
+ * Maps framework effects, strengths and composition primitives to Meizu
+ * effect ids and strength bytes.
+ *
+ * Entries are indexed by their enum values, which are shared by every
+ * IVibrator version. Built-in defaults can be overridden by a config file
+ * with one entry per line:
+ *
+ *   effect <EFFECT> <id> <durationMs>
+ *   strength <STRENGTH> <byte>
+ *   effect_strength <EFFECT> <STRENGTH> <byte>
+ *   primitive <PRIMITIVE> <id> <durationMs>
+ *
+ * A strength line sets the byte for every effect without an effect_strength
+ * line of its own.
+ */
+class EffectTable {
+  public:
+    // Effect::CLICK to Effect::TEXTURE_TICK. HIDL's V1_2::Effect stops at
+    // RINGTONE_15, the extra entry is for the stable AIDL Effect.
+    static constexpr size_t kEffectCount = 22;
+    // EffectStrength::LIGHT to EffectStrength::STRONG.
+    static constexpr size_t kStrengthCount = 3;
+    // CompositePrimitive::NOOP to CompositePrimitive::LIGHT_TICK.
+    static constexpr size_t kPrimitiveCount = 8;
+
+    EffectTable();
+
+    // Returns false if the file could not be read. Invalid lines are skipped.
+    bool load(const std::string &path);
+
+    // Returns nullptr if the effect is unsupported.
+    const EffectInfo *effect(uint32_t effect) const;
+    // The strength byte to play an effect with at a framework strength.
+    bool strength(uint32_t effect, uint32_t strength, uint8_t *value) const;
+    // Returns nullptr if the primitive is unsupported. NOOP is supported with an id of 0.
+    const EffectInfo *primitive(uint32_t primitive) const;
+
+  private:
+    // An mEffectStrengths entry that defers to mStrengths.
+    static constexpr int16_t kDefaultStrength = -1;
+
+    std::array<EffectInfo, kEffectCount> mEffects;
+    std::array<uint8_t, kStrengthCount> mStrengths;
+    std::array<std::array<int16_t, kStrengthCount>, kEffectCount> mEffectStrengths;
+    std::array<EffectInfo, kPrimitiveCount> mPrimitives;
+};
+
+}  // namespace sm8150
+}  // namespace meizu
+
+#endif  // MEIZU_SM8150_VIBRATOR_EFFECTTABLE_H
@@ -17,47 +17,68 @@
 
 #define LOG_TAG "VibratorService"
 
+#include <android-base/file.h>
 #include <android-base/logging.h>
 
 #include "Vibrator.h"
 
+using android::base::WriteStringToFd;
+using meizu::sm8150::EffectTable;
+
 namespace android {
 namespace hardware {
 namespace vibrator {
 namespace V1_2 {
 namespace implementation {
 
-Vibrator::Vibrator(vibrator_device_t *device)
-    : mDevice(device)
-    {
+static_assert(static_cast<size_t>(Effect::RINGTONE_15) < EffectTable::kEffectCount,
+              "EffectTable must cover every V1_2::Effect");
+static_assert(static_cast<size_t>(EffectStrength::STRONG) + 1 == EffectTable::kStrengthCount,
+              "EffectTable must cover every EffectStrength");
+static_assert(static_cast<size_t>(CompositePrimitive::LIGHT_TICK) + 1 ==
+                      EffectTable::kPrimitiveCount,
+              "EffectTable must cover every CompositePrimitive");
+
+static Status toStatus(VibratorCore::Result result) {
+    switch (result) {
+        case VibratorCore::Result::OK:
+            return Status::OK;
+        case VibratorCore::Result::UNSUPPORTED:
+            return Status::UNSUPPORTED_OPERATION;
+        case VibratorCore::Result::BAD_VALUE:
+            return Status::BAD_VALUE;
+        default:
+            return Status::UNKNOWN_ERROR;
+    }
+}
+
+Vibrator::Vibrator(vibrator_device_t *device, const VibratorCore::Config &config)
+    : mCore(device, config) {}
+
+void Vibrator::warmUp() {
+    mCore.warmUp();
+}
+
+void Vibrator::setWorkerPriority(int priority) {
+    mCore.setWorkerPriority(priority);
 }
 
 // Methods from ::android::hardware::vibrator::V1_0::IVibrator follow.
 
 Return<Status> Vibrator::on(uint32_t timeoutMs) {
-    int32_t ret = mDevice->vibrator_on(mDevice, timeoutMs);
-    if (ret != 0) {
-        LOG(ERROR) << "On: command failed: " << strerror(-ret);
-        return Status::UNKNOWN_ERROR;
-    }
-    return Status::OK;
+    return toStatus(mCore.on(timeoutMs));
 }
 
 Return<Status> Vibrator::off() {
-    int32_t ret = mDevice->vibrator_off(mDevice);
-    if (ret != 0) {
-        LOG(ERROR) << "Off: command failed: " << strerror(-ret);
-        return Status::UNKNOWN_ERROR;
-    }
-    return Status::OK;
+    return toStatus(mCore.off());
 }
 
 Return<bool> Vibrator::supportsAmplitudeControl() {
-    return false;
+    return mCore.supportsAmplitudeControl();
 }
 
-Return<Status> Vibrator::setAmplitude(uint8_t) {
-    return Status::UNSUPPORTED_OPERATION;
+Return<Status> Vibrator::setAmplitude(uint8_t amplitude) {
+    return toStatus(mCore.setAmplitude(amplitude / static_cast<float>(UINT8_MAX)));
 }
 
 Return<void> Vibrator::perform(V1_0::Effect effect, EffectStrength strength, perform_cb _hidl_cb) {
@@ -78,63 +99,68 @@ Return<void> Vibrator::perform_1_2(V1_2::Effect effect, EffectStrength strength,
     return perform<decltype(effect)>(effect, strength, _hidl_cb);
 }
 
-// Private methods follow.
+// Methods from ::vendor::meizu::hardware::vibrator::V1_0::IVibratorExt follow.
 
-Return<void> Vibrator::perform(Effect effect, EffectStrength strength, perform_cb _hidl_cb) {
-    uint32_t id;
-    uint8_t strn;
-    Status status = Status::OK;
-
-    switch (effect) {
-        case Effect::CLICK:
-            id = 31008;
-            break;
-        case Effect::DOUBLE_CLICK:
-            id = 31003;
-            break;
-        case Effect::TICK:
-            id = 21000;
-            break;
-        case Effect::THUD:
-            id = 30900;
-            break;
-        case Effect::POP:
-            id = 22520;
-            break;
-        case Effect::HEAVY_CLICK:
-            id = 30900;
-            break;
-        default:
-            LOG(ERROR) << "Perform: Effect not supported: " << toString(effect);
-            _hidl_cb(status, 0);
-            return Void();
+Return<void> Vibrator::getSupportedPrimitives(getSupportedPrimitives_cb _hidl_cb) {
+    std::vector<CompositePrimitive> primitives;
+
+    for (uint32_t primitive : mCore.supportedPrimitives()) {
+        primitives.push_back(static_cast<CompositePrimitive>(primitive));
     }
 
-    switch (strength) {
-        case EffectStrength::LIGHT:
-            strn = 50;
-            break;
-        case EffectStrength::MEDIUM:
-            strn = 120;
-            break;
-        case EffectStrength::STRONG:
-            strn = 255;
-            break;
+    _hidl_cb(primitives);
+    return Void();
+}
+
+Return<void> Vibrator::compose(const hidl_vec<CompositeEffect> &composite, compose_cb _hidl_cb) {
+    std::vector<VibratorCore::Primitive> primitives;
+    uint32_t durationMs = 0;
+
+    primitives.reserve(composite.size());
+    for (const auto &effect : composite) {
+        primitives.push_back(
+                {static_cast<uint32_t>(effect.primitive), effect.scale, effect.delayMs});
     }
 
-    int32_t ret = mDevice->vibrator_perform_effect(mDevice, id, strn);
-    if (ret != 0) {
-        LOG(ERROR) << "Perform: command failed: " << strerror(-ret);
-        status = Status::UNKNOWN_ERROR;
-        _hidl_cb(status, 0);
+    Status status = toStatus(mCore.compose(primitives, &durationMs));
+    _hidl_cb(status, status == Status::OK ? durationMs : 0);
+    return Void();
+}
+
+// Methods from ::android::hidl::base::V1_0::IBase follow.
+
+Return<void> Vibrator::debug(const hidl_handle &handle, const hidl_vec<hidl_string> &args) {
+    const native_handle_t *nativeHandle = handle.getNativeHandle();
+    if (nativeHandle == nullptr || nativeHandle->numFds < 1) {
+        LOG(ERROR) << "debug: invalid handle";
         return Void();
     }
 
-    LOG(INFO) << "Perform: Effect " << toString(effect) << " (" << toString(strength)  << ")"
-              << " => " << id << " (" << (int) strn << ")";
+    for (const auto &arg : args) {
+        if (arg == "--reset") {
+            mCore.resetStats();
+        }
+    }
+
+    std::string out =
+            mCore.dump([](uint32_t effect) { return toString(static_cast<Effect>(effect)); });
 
-    _hidl_cb(status, 200);
+    WriteStringToFd(out, nativeHandle->data[0]);
+    return Void();
+}
+
+// Private methods follow.
+
+Return<void> Vibrator::perform(Effect effect, EffectStrength strength, perform_cb _hidl_cb) {
+    uint32_t durationMs = 0;
+
+    Status status = toStatus(mCore.perform(static_cast<uint32_t>(effect),
+                                           static_cast<uint32_t>(strength), &durationMs));
+    if (status == Status::UNSUPPORTED_OPERATION) {
+        LOG(ERROR) << "Perform: Effect not supported: " << toString(effect);
+    }
 
+    _hidl_cb(status, durationMs);
     return Void();
 }
 
@@ -19,7 +19,9 @@
 
 #include <android/hardware/vibrator/1.2/IVibrator.h>
 #include <hidl/Status.h>
+#include <vendor/meizu/hardware/vibrator/1.0/IVibratorExt.h>
 
+#include "VibratorCore.h"
 #include "hardware/vibrator.h"
 
 namespace android {
@@ -31,9 +33,18 @@ namespace implementation {
 using android::hardware::vibrator::V1_0::EffectStrength;
 using android::hardware::vibrator::V1_0::Status;
 
-class Vibrator : public IVibrator {
+using ::meizu::sm8150::VibratorCore;
+using ::vendor::meizu::hardware::vibrator::V1_0::CompositeEffect;
+using ::vendor::meizu::hardware::vibrator::V1_0::CompositePrimitive;
+using ::vendor::meizu::hardware::vibrator::V1_0::IVibratorExt;
+
+class Vibrator : public IVibratorExt {
   public:
-    Vibrator(vibrator_device_t *device);
+    Vibrator(vibrator_device_t *device, const VibratorCore::Config &config);
+
+    // Play a zero-strength effect ahead of the first real one.
+    void warmUp();
+    void setWorkerPriority(int priority);
 
     // Methods from ::android::hardware::vibrator::V1_0::IVibrator follow.
     Return<Status> on(uint32_t timeoutMs) override;
@@ -51,13 +62,21 @@ class Vibrator : public IVibrator {
     Return<void> perform_1_2(V1_2::Effect effect, EffectStrength strength,
                              perform_cb _hidl_cb) override;
 
+    // Methods from ::vendor::meizu::hardware::vibrator::V1_0::IVibratorExt follow.
+    Return<void> getSupportedPrimitives(getSupportedPrimitives_cb _hidl_cb) override;
+    Return<void> compose(const hidl_vec<CompositeEffect> &composite,
+                         compose_cb _hidl_cb) override;
+
+    // Methods from ::android::hidl::base::V1_0::IBase follow.
+    Return<void> debug(const hidl_handle &handle, const hidl_vec<hidl_string> &args) override;
+
   private:
     Return<void> perform(Effect effect, EffectStrength strength, perform_cb _hidl_cb);
     template <typename T>
     Return<void> perform(T effect, EffectStrength strength, perform_cb _hidl_cb);
 
   private:
-    vibrator_device_t *mDevice;
+    VibratorCore mCore;
 };
 }  // namespace implementation
 }  // namespace V1_2
@@ -0,0 +1,243 @@
+/*
+ * Copyright (C) 2020 The MoKee Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "VibratorService"
+
+#include <android-base/logging.h>
+#include <android-base/stringprintf.h>
+#include <algorithm>
+#include <cmath>
+
+#include "VibratorCore.h"
+
+/*
+ * The "gain" attribute of the Awinic AW8697 haptics driver, which registers
+ * its LED class device as "vibrator". The driver takes gains from 0 to 0x80,
+ * where 0x80 plays at full scale. Without the node, amplitude control is
+ * reported as unsupported.
+ */
+#define VIBRATOR_GAIN_PATH "/sys/class/leds/vibrator/gain"
+#define GAIN_MAX 0x80
+
+using android::base::StringAppendF;
+
+namespace meizu {
+namespace sm8150 {
+
+// Framework values of Effect::CLICK and Effect::TICK.
+static constexpr uint32_t kEffectClick = 0;
+static constexpr uint32_t kEffectTick = 2;
+
+VibratorCore::VibratorCore(vibrator_device_t *device, const Config &config)
+    : mDevice(device),
+      mEffects(device),
+      mComposer(device),
+      mGain(config.sysfsRoot + VIBRATOR_GAIN_PATH),
+      mAmplitudeControl(mGain.exists()),
+      mGainValue(GAIN_MAX) {
+    if (!config.effectTablePath.empty() && mEffectTable.load(config.effectTablePath)) {
+        LOG(INFO) << "Loaded effect table from " << config.effectTablePath;
+    }
+
+    LOG(INFO) << "Amplitude control " << (mAmplitudeControl ? "supported" : "not supported");
+}
+
+void VibratorCore::warmUp() {
+    const EffectInfo *info = mEffectTable.effect(kEffectTick);
+
+    if (info == nullptr) {
+        info = mEffectTable.effect(kEffectClick);
+    }
+    if (info == nullptr) {
+        LOG(WARNING) << "No effect to warm up the driver with";
+        return;
+    }
+
+    mEffects.warmUp(info->id);
+}
+
+void VibratorCore::setWorkerPriority(int priority) {
+    mEffects.setRealtimePriority(priority);
+}
+
+std::vector<uint32_t> VibratorCore::supportedEffects() const {
+    std::vector<uint32_t> effects;
+
+    for (uint32_t i = 0; i < EffectTable::kEffectCount; i++) {
+        if (mEffectTable.effect(i) != nullptr) {
+            effects.push_back(i);
+        }
+    }
+    return effects;
+}
+
+std::vector<uint32_t> VibratorCore::supportedPrimitives() const {
+    std::vector<uint32_t> primitives;
+
+    for (uint32_t i = 0; i < EffectTable::kPrimitiveCount; i++) {
+        if (mEffectTable.primitive(i) != nullptr) {
+            primitives.push_back(i);
+        }
+    }
+    return primitives;
+}
+
+bool VibratorCore::primitiveDuration(uint32_t primitive, uint32_t *durationMs) const {
+    const EffectInfo *info = mEffectTable.primitive(primitive);
+
+    if (info == nullptr) {
+        return false;
+    }
+
+    *durationMs = info->durationMs;
+    return true;
+}
+
+VibratorCore::Result VibratorCore::on(uint32_t timeoutMs) {
+    VibratorStats::CallTimer timer(mStats, VibratorStats::Call::ON);
+
+    mEffects.flush();
+    mComposer.cancel();
+
+    if (mAmplitudeControl) {
+        // A no-op unless an effect touched the gain since the last write.
+        mGain.write(mGainValue);
+    }
+
+    int32_t ret = mDevice->vibrator_on(mDevice, timeoutMs);
+    if (ret != 0) {
+        LOG(ERROR) << "On: command failed: " << strerror(-ret);
+        timer.fail();
+        return Result::FAILED;
+    }
+    return Result::OK;
+}
+
+VibratorCore::Result VibratorCore::off() {
+    VibratorStats::CallTimer timer(mStats, VibratorStats::Call::OFF);
+
+    mEffects.flush();
+    mComposer.cancel();
+
+    int32_t ret = mDevice->vibrator_off(mDevice);
+    if (ret != 0) {
+        LOG(ERROR) << "Off: command failed: " << strerror(-ret);
+        timer.fail();
+        return Result::FAILED;
+    }
+    return Result::OK;
+}
+
+VibratorCore::Result VibratorCore::setAmplitude(float amplitude) {
+    VibratorStats::CallTimer timer(mStats, VibratorStats::Call::SET_AMPLITUDE);
+
+    if (!mAmplitudeControl) {
+        return Result::UNSUPPORTED;
+    }
+
+    if (!(amplitude > 0.0f && amplitude <= 1.0f)) {
+        return Result::BAD_VALUE;
+    }
+
+    mGainValue = std::max<uint32_t>(std::lround(amplitude * GAIN_MAX), 1);
+    if (!mGain.write(mGainValue)) {
+        timer.fail();
+        return Result::FAILED;
+    }
+    return Result::OK;
+}
+
+VibratorCore::Result VibratorCore::perform(uint32_t effect, uint32_t strength,
+                                           uint32_t *durationMs) {
+    VibratorStats::CallTimer timer(mStats, VibratorStats::Call::PERFORM);
+    const EffectInfo *info = mEffectTable.effect(effect);
+    uint8_t strn;
+
+    if (info == nullptr || !mEffectTable.strength(effect, strength, &strn)) {
+        return Result::UNSUPPORTED;
+    }
+
+    // A new effect supersedes any composition still playing.
+    mComposer.cancel();
+
+    // Played on the effect queue's worker, driver errors are logged there.
+    mEffects.push(info->id, strn);
+    mStats.recordEffect(effect);
+
+    // Effects are played with their own strength, which may change the gain.
+    mGain.invalidate();
+
+    *durationMs = info->durationMs;
+    return Result::OK;
+}
+
+VibratorCore::Result VibratorCore::compose(const std::vector<Primitive> &primitives,
+                                           uint32_t *durationMs) {
+    VibratorStats::CallTimer timer(mStats, VibratorStats::Call::COMPOSE);
+    std::vector<ComposeStep> steps;
+    uint32_t offsetMs = 0;
+
+    if (primitives.size() > Composer::kSizeMax) {
+        return Result::BAD_VALUE;
+    }
+
+    steps.reserve(primitives.size());
+    for (const auto &primitive : primitives) {
+        if (primitive.delayMs > Composer::kDelayMaxMs ||
+            !(primitive.scale >= 0.0f && primitive.scale <= 1.0f)) {
+            return Result::BAD_VALUE;
+        }
+
+        const EffectInfo *info = mEffectTable.primitive(primitive.primitive);
+        if (info == nullptr) {
+            return Result::UNSUPPORTED;
+        }
+
+        offsetMs += primitive.delayMs;
+        steps.push_back({offsetMs, info->id, Composer::strengthForScale(primitive.scale)});
+        offsetMs += info->durationMs;
+    }
+
+    mEffects.flush();
+    mComposer.start(std::move(steps));
+
+    // Primitives are played with their own strength, which may change the gain.
+    mGain.invalidate();
+
+    *durationMs = offsetMs;
+    return Result::OK;
+}
+
+void VibratorCore::resetStats() {
+    mStats.reset();
+    mEffects.resetStats();
+    mComposer.resetStats();
+}
+
+std::string VibratorCore::dump(const std::function<std::string(uint32_t)> &effectName) const {
+    std::string out = mStats.dump(effectName);
+
+    out += mEffects.dump();
+    StringAppendF(&out, "composer errors=%llu\n",
+                  static_cast<unsigned long long>(mComposer.errors()));
+    StringAppendF(&out, "%s: cache hits=%llu misses=%llu\n", mGain.path().c_str(),
+                  static_cast<unsigned long long>(mGain.cacheHits()),
+                  static_cast<unsigned long long>(mGain.cacheMisses()));
+    return out;
+}
+
+}  // namespace sm8150
+}  // namespace meizu
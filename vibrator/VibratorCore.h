@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2020 The MoKee Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MEIZU_SM8150_VIBRATOR_VIBRATORCORE_H
+#define MEIZU_SM8150_VIBRATOR_VIBRATORCORE_H
+
+#include <functional>
+#include <meizu/SysfsNode.h>
+#include <string>
+#include <vector>
+
+#include "Composer.h"
+#include "EffectQueue.h"
+#include "EffectTable.h"
+#include "VibratorStats.h"
+#include "hardware/vibrator.h"
+
+namespace meizu {
+namespace sm8150 {
+
+/*
+ * The vibrator behind both the HIDL and the AIDL service.
+ *
+ * Validates requests, looks effects up in the effect table, keeps the
+ * driver gain and plays effects and compositions without blocking the
+ * caller. Effects, strengths and primitives are passed as the values of
+ * the framework enums, which every interface version shares, so the
+ * services only convert types and results.
+ */
+class VibratorCore {
+  public:
+    enum class Result { OK, UNSUPPORTED, BAD_VALUE, FAILED };
+
+    struct Config {
+        // Prepended to every sysfs path.
+        std::string sysfsRoot;
+        // Optional effect table overriding the built-in one.
+        std::string effectTablePath;
+    };
+
+    struct Primitive {
+        uint32_t primitive;
+        // In [0, 1].
+        float scale;
+        uint32_t delayMs;
+    };
+
+    VibratorCore(vibrator_device_t *device, const Config &config);
+
+    // Play a zero-strength effect ahead of the first real one.
+    void warmUp();
+    void setWorkerPriority(int priority);
+
+    bool supportsAmplitudeControl() const { return mAmplitudeControl; }
+    std::vector<uint32_t> supportedEffects() const;
+    std::vector<uint32_t> supportedPrimitives() const;
+    // Returns false if the primitive is unsupported.
+    bool primitiveDuration(uint32_t primitive, uint32_t *durationMs) const;
+
+    Result on(uint32_t timeoutMs);
+    Result off();
+    // amplitude is in (0, 1].
+    Result setAmplitude(float amplitude);
+    // On success, durationMs is how long the effect plays.
+    Result perform(uint32_t effect, uint32_t strength, uint32_t *durationMs);
+    Result compose(const std::vector<Primitive> &primitives, uint32_t *durationMs);
+
+    void resetStats();
+    // Effects are named through the given callback, see VibratorStats::dump().
+    std::string dump(const std::function<std::string(uint32_t)> &effectName) const;
+
+  private:
+    vibrator_device_t *mDevice;
+    EffectQueue mEffects;
+    EffectTable mEffectTable;
+    Composer mComposer;
+    VibratorStats mStats;
+
+    // Driver gain, written from the framework amplitude. Kept across on() calls.
+    SysfsNode mGain;
+    bool mAmplitudeControl;
+    uint32_t mGainValue;
+};
+
+}  // namespace sm8150
+}  // namespace meizu
+
+#endif  // MEIZU_SM8150_VIBRATOR_VIBRATORCORE_H
@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2020 The MoKee Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <android-base/stringprintf.h>
+
+#include "VibratorStats.h"
+
+using android::base::StringAppendF;
+
+namespace meizu {
+namespace sm8150 {
+
+static constexpr const char *kCallNames[VibratorStats::kCallCount] = {
+        "on", "off", "setAmplitude", "perform", "compose",
+};
+
+VibratorStats::VibratorStats() {
+    reset();
+}
+
+void VibratorStats::recordCall(Call call, int64_t ns, bool failed) {
+    CallStats &stats = mCalls[static_cast<size_t>(call)];
+
+    stats.latency.record(ns);
+    if (failed) {
+        stats.errors.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void VibratorStats::recordEffect(uint32_t effect) {
+    if (effect < mEffects.size()) {
+        mEffects[effect].fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void VibratorStats::reset() {
+    for (auto &stats : mCalls) {
+        stats.latency.reset();
+        stats.errors.store(0, std::memory_order_relaxed);
+    }
+    for (auto &count : mEffects) {
+        count.store(0, std::memory_order_relaxed);
+    }
+}
+
+std::string VibratorStats::dump(const std::function<std::string(uint32_t)> &effectName) const {
+    std::string out;
+
+    for (size_t i = 0; i < kCallCount; i++) {
+        out += mCalls[i].latency.dump(kCallNames[i]);
+        StringAppendF(&out, "%s errors=%llu\n", kCallNames[i],
+                      static_cast<unsigned long long>(
+                              mCalls[i].errors.load(std::memory_order_relaxed)));
+    }
+
+    out += "effects:\n";
+    for (uint32_t i = 0; i < mEffects.size(); i++) {
+        uint64_t n = mEffects[i].load(std::memory_order_relaxed);
+        if (n != 0) {
+            StringAppendF(&out, "    %s: %llu\n", effectName(i).c_str(),
+                          static_cast<unsigned long long>(n));
+        }
+    }
+
+    return out;
+}
+
+}  // namespace sm8150
+}  // namespace meizu
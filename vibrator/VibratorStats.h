@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2020 The MoKee Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MEIZU_SM8150_VIBRATOR_VIBRATORSTATS_H
+#define MEIZU_SM8150_VIBRATOR_VIBRATORSTATS_H
+
+#include <array>
+#include <atomic>
+#include <functional>
+#include <meizu/LatencyHistogram.h>
+#include <string>
+
+#include "EffectTable.h"
+
+namespace meizu {
+namespace sm8150 {
+
+/*
+ * Per-call latency and error counters, plus how often each effect was
+ * played. Every method may be called from any thread.
+ */
+class VibratorStats {
+  public:
+    enum class Call {
+        ON,
+        OFF,
+        SET_AMPLITUDE,
+        PERFORM,
+        COMPOSE,
+        COUNT,
+    };
+
+    static constexpr size_t kCallCount = static_cast<size_t>(Call::COUNT);
+
+    // Records the latency of a call when it goes out of scope.
+    class CallTimer {
+      public:
+        CallTimer(VibratorStats &stats, Call call)
+            : mStats(stats), mCall(call), mStartNs(monotonicNs()), mFailed(false) {}
+        ~CallTimer() { mStats.recordCall(mCall, monotonicNs() - mStartNs, mFailed); }
+
+        void fail() { mFailed = true; }
+
+      private:
+        VibratorStats &mStats;
+        Call mCall;
+        int64_t mStartNs;
+        bool mFailed;
+    };
+
+    VibratorStats();
+
+    void recordCall(Call call, int64_t ns, bool failed);
+    void recordEffect(uint32_t effect);
+
+    void reset();
+
+    // Effects are named through the given callback, since the HIDL enum
+    // names are not known here.
+    std::string dump(const std::function<std::string(uint32_t)> &effectName) const;
+
+  private:
+    struct CallStats {
+        LatencyHistogram latency;
+        std::atomic<uint64_t> errors;
+    };
+
+    std::array<CallStats, kCallCount> mCalls;
+    std::array<std::atomic<uint64_t>, EffectTable::kEffectCount> mEffects;
+};
+
+}  // namespace sm8150
+}  // namespace meizu
+
+#endif  // MEIZU_SM8150_VIBRATOR_VIBRATORSTATS_H
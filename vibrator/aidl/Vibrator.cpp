@@ -0,0 +1,233 @@
+/*
+ * Copyright (C) 2020 The MoKee Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "VibratorService"
+
+#include <android-base/file.h>
+#include <android-base/logging.h>
+
+#include "Vibrator.h"
+
+using android::base::WriteStringToFd;
+using meizu::sm8150::Composer;
+using meizu::sm8150::EffectTable;
+
+namespace aidl {
+namespace android {
+namespace hardware {
+namespace vibrator {
+
+static_assert(static_cast<size_t>(Effect::TEXTURE_TICK) + 1 == EffectTable::kEffectCount,
+              "EffectTable must cover every Effect");
+static_assert(static_cast<size_t>(EffectStrength::STRONG) + 1 == EffectTable::kStrengthCount,
+              "EffectTable must cover every EffectStrength");
+static_assert(static_cast<size_t>(CompositePrimitive::LIGHT_TICK) + 1 ==
+                      EffectTable::kPrimitiveCount,
+              "EffectTable must cover every CompositePrimitive");
+
+static ndk::ScopedAStatus unsupported() {
+    return ndk::ScopedAStatus::fromExceptionCode(EX_UNSUPPORTED_OPERATION);
+}
+
+static ndk::ScopedAStatus illegalArgument() {
+    return ndk::ScopedAStatus::fromExceptionCode(EX_ILLEGAL_ARGUMENT);
+}
+
+static ndk::ScopedAStatus toStatus(VibratorCore::Result result) {
+    switch (result) {
+        case VibratorCore::Result::OK:
+            return ndk::ScopedAStatus::ok();
+        case VibratorCore::Result::UNSUPPORTED:
+            return unsupported();
+        case VibratorCore::Result::BAD_VALUE:
+            return illegalArgument();
+        default:
+            return ndk::ScopedAStatus::fromExceptionCode(EX_ILLEGAL_STATE);
+    }
+}
+
+Vibrator::Vibrator(vibrator_device_t *device, const VibratorCore::Config &config)
+    : mCore(device, config) {}
+
+void Vibrator::warmUp() {
+    mCore.warmUp();
+}
+
+void Vibrator::setWorkerPriority(int priority) {
+    mCore.setWorkerPriority(priority);
+}
+
+ndk::ScopedAStatus Vibrator::getCapabilities(int32_t *_aidl_return) {
+    *_aidl_return = IVibrator::CAP_ON_CALLBACK | IVibrator::CAP_PERFORM_CALLBACK |
+                    IVibrator::CAP_COMPOSE_EFFECTS;
+    if (mCore.supportsAmplitudeControl()) {
+        *_aidl_return |= IVibrator::CAP_AMPLITUDE_CONTROL;
+    }
+    return ndk::ScopedAStatus::ok();
+}
+
+ndk::ScopedAStatus Vibrator::off() {
+    mCompletion.cancel();
+    return toStatus(mCore.off());
+}
+
+ndk::ScopedAStatus Vibrator::on(int32_t timeoutMs,
+                                const std::shared_ptr<IVibratorCallback> &callback) {
+    if (timeoutMs <= 0) {
+        return illegalArgument();
+    }
+
+    VibratorCore::Result result = mCore.on(timeoutMs);
+    if (result == VibratorCore::Result::OK) {
+        notifyAfter(timeoutMs, callback);
+    }
+    return toStatus(result);
+}
+
+ndk::ScopedAStatus Vibrator::perform(Effect effect, EffectStrength strength,
+                                     const std::shared_ptr<IVibratorCallback> &callback,
+                                     int32_t *_aidl_return) {
+    uint32_t durationMs;
+
+    VibratorCore::Result result = mCore.perform(static_cast<uint32_t>(effect),
+                                                static_cast<uint32_t>(strength), &durationMs);
+    if (result == VibratorCore::Result::UNSUPPORTED) {
+        LOG(ERROR) << "Perform: Effect not supported: " << toString(effect);
+    }
+    if (result != VibratorCore::Result::OK) {
+        return toStatus(result);
+    }
+
+    notifyAfter(durationMs, callback);
+    *_aidl_return = durationMs;
+    return ndk::ScopedAStatus::ok();
+}
+
+ndk::ScopedAStatus Vibrator::getSupportedEffects(std::vector<Effect> *_aidl_return) {
+    _aidl_return->clear();
+    for (uint32_t effect : mCore.supportedEffects()) {
+        _aidl_return->push_back(static_cast<Effect>(effect));
+    }
+    return ndk::ScopedAStatus::ok();
+}
+
+ndk::ScopedAStatus Vibrator::setAmplitude(float amplitude) {
+    return toStatus(mCore.setAmplitude(amplitude));
+}
+
+ndk::ScopedAStatus Vibrator::setExternalControl(bool /* enabled */) {
+    return unsupported();
+}
+
+ndk::ScopedAStatus Vibrator::getCompositionDelayMax(int32_t *maxDelayMs) {
+    *maxDelayMs = Composer::kDelayMaxMs;
+    return ndk::ScopedAStatus::ok();
+}
+
+ndk::ScopedAStatus Vibrator::getCompositionSizeMax(int32_t *maxSize) {
+    *maxSize = Composer::kSizeMax;
+    return ndk::ScopedAStatus::ok();
+}
+
+ndk::ScopedAStatus Vibrator::getSupportedPrimitives(std::vector<CompositePrimitive> *supported) {
+    supported->clear();
+    for (uint32_t primitive : mCore.supportedPrimitives()) {
+        supported->push_back(static_cast<CompositePrimitive>(primitive));
+    }
+    return ndk::ScopedAStatus::ok();
+}
+
+ndk::ScopedAStatus Vibrator::getPrimitiveDuration(CompositePrimitive primitive,
+                                                  int32_t *durationMs) {
+    uint32_t duration;
+
+    if (!mCore.primitiveDuration(static_cast<uint32_t>(primitive), &duration)) {
+        return unsupported();
+    }
+
+    *durationMs = duration;
+    return ndk::ScopedAStatus::ok();
+}
+
+ndk::ScopedAStatus Vibrator::compose(const std::vector<CompositeEffect> &composite,
+                                     const std::shared_ptr<IVibratorCallback> &callback) {
+    std::vector<VibratorCore::Primitive> primitives;
+    uint32_t durationMs;
+
+    primitives.reserve(composite.size());
+    for (const auto &effect : composite) {
+        if (effect.delayMs < 0) {
+            return illegalArgument();
+        }
+        primitives.push_back({static_cast<uint32_t>(effect.primitive), effect.scale,
+                              static_cast<uint32_t>(effect.delayMs)});
+    }
+
+    VibratorCore::Result result = mCore.compose(primitives, &durationMs);
+    if (result == VibratorCore::Result::OK) {
+        notifyAfter(durationMs, callback);
+    }
+    return toStatus(result);
+}
+
+ndk::ScopedAStatus Vibrator::getSupportedAlwaysOnEffects(std::vector<Effect> * /* _aidl_return */) {
+    return unsupported();
+}
+
+ndk::ScopedAStatus Vibrator::alwaysOnEnable(int32_t /* id */, Effect /* effect */,
+                                            EffectStrength /* strength */) {
+    return unsupported();
+}
+
+ndk::ScopedAStatus Vibrator::alwaysOnDisable(int32_t /* id */) {
+    return unsupported();
+}
+
+binder_status_t Vibrator::dump(int fd, const char **args, uint32_t numArgs) {
+    for (uint32_t i = 0; i < numArgs; i++) {
+        if (std::string(args[i]) == "--reset") {
+            mCore.resetStats();
+        }
+    }
+
+    std::string out =
+            mCore.dump([](uint32_t effect) { return toString(static_cast<Effect>(effect)); });
+
+    WriteStringToFd(out, fd);
+    return STATUS_OK;
+}
+
+/*
+ * Tell the framework when the vibration ends, so that it does not have to
+ * sleep for a guessed duration. A newer vibration drops the pending callback.
+ */
+void Vibrator::notifyAfter(uint32_t delayMs, const std::shared_ptr<IVibratorCallback> &callback) {
+    if (callback == nullptr) {
+        mCompletion.cancel();
+        return;
+    }
+
+    mCompletion.schedule(delayMs, [callback] {
+        if (!callback->onComplete().isOk()) {
+            LOG(ERROR) << "Failed to deliver vibration completion";
+        }
+    });
+}
+
+}  // namespace vibrator
+}  // namespace hardware
+}  // namespace android
+}  // namespace aidl
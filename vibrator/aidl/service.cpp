@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2020 The MoKee Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#define LOG_TAG "android.hardware.vibrator-service.meizu_sm8150"
+
+#include <android-base/logging.h>
+#include <android-base/properties.h>
+#include <android/binder_manager.h>
+#include <android/binder_process.h>
+
+#include "Vibrator.h"
+
+using aidl::android::hardware::vibrator::Vibrator;
+using android::base::GetBoolProperty;
+using android::base::GetUintProperty;
+using meizu::sm8150::VibratorCore;
+
+int main() {
+    vibrator_device_t *vib_device;
+    const hw_module_t *hw_module = nullptr;
+
+    int ret = hw_get_module(VIBRATOR_HARDWARE_MODULE_ID, &hw_module);
+    if (ret == 0) {
+        ret = vibrator_open(hw_module, &vib_device);
+        if (ret != 0) {
+            LOG(ERROR) << "vibrator_open failed: " << ret;
+            return ret;
+        }
+    } else {
+        LOG(ERROR) << "hw_get_module " << VIBRATOR_HARDWARE_MODULE_ID
+                   << " failed: " << ret;
+        return ret;
+    }
+
+    VibratorCore::Config config;
+    config.effectTablePath = "/vendor/etc/vibrator/effects.conf";
+
+    std::shared_ptr<Vibrator> vibrator = ndk::SharedRefBase::make<Vibrator>(vib_device, config);
+
+    uint32_t priority = GetUintProperty<uint32_t>("ro.vendor.vibrator.worker_priority", 0);
+    if (priority > 0) {
+        vibrator->setWorkerPriority(priority);
+    }
+    if (GetBoolProperty("ro.vendor.vibrator.warmup", false)) {
+        vibrator->warmUp();
+    }
+
+    ABinderProcess_setThreadPoolMaxThreadCount(0);
+
+    const std::string instance = std::string() + Vibrator::descriptor + "/default";
+    binder_status_t status = AServiceManager_addService(vibrator->asBinder().get(),
+                                                        instance.c_str());
+    if (status != STATUS_OK) {
+        LOG(ERROR) << "Cannot register Vibrator HAL service";
+        return 1;
+    }
+
+    ABinderProcess_joinThreadPool();
+    // Under normal cases, execution will not reach this line.
+    return 1;
+}
@@ -17,14 +17,17 @@
 #define LOG_TAG "android.hardware.vibrator@1.2-service.meizu_sm8150"
 
 #include <android-base/logging.h>
+#include <android-base/properties.h>
 #include <hidl/HidlTransportSupport.h>
 
 #include "Vibrator.h"
 
+using android::base::GetBoolProperty;
+using android::base::GetUintProperty;
 using android::hardware::configureRpcThreadpool;
 using android::hardware::joinRpcThreadpool;
-using android::hardware::vibrator::V1_2::IVibrator;
 using android::hardware::vibrator::V1_2::implementation::Vibrator;
+using meizu::sm8150::VibratorCore;
 
 int main() {
     vibrator_device_t *vib_device;
@@ -43,7 +46,18 @@ int main() {
         return ret;
     }
 
-    android::sp<IVibrator> vibrator = new Vibrator(vib_device);
+    VibratorCore::Config config;
+    config.effectTablePath = "/vendor/etc/vibrator/effects.conf";
+
+    android::sp<Vibrator> vibrator = new Vibrator(vib_device, config);
+
+    uint32_t priority = GetUintProperty<uint32_t>("ro.vendor.vibrator.worker_priority", 0);
+    if (priority > 0) {
+        vibrator->setWorkerPriority(priority);
+    }
+    if (GetBoolProperty("ro.vendor.vibrator.warmup", false)) {
+        vibrator->warmUp();
+    }
 
     configureRpcThreadpool(1, true);
 
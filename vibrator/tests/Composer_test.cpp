@@ -0,0 +1,121 @@
+/*
+ * Copyright (C) 2020 The MoKee Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <meizu/LatencyHistogram.h>
+
+#include <chrono>
+#include <thread>
+
+#include "Composer.h"
+#include "FakeVibratorDevice.h"
+
+using meizu::sm8150::Composer;
+using meizu::sm8150::FakeVibratorDevice;
+using meizu::sm8150::monotonicNs;
+
+namespace {
+
+using Op = FakeVibratorDevice::Op;
+
+// Timer slack allowed on a loaded host.
+constexpr int64_t kSlackNs = 20 * 1000000LL;
+
+TEST(ComposerTest, PlaysStepsAtTheirOffsets) {
+    FakeVibratorDevice fake;
+    Composer composer(fake.device());
+
+    int64_t startNs = monotonicNs();
+    composer.start({{0, 31008, 255}, {30, 0, 0}, {60, 21000, 128}});
+
+    ASSERT_TRUE(fake.waitForCalls(2, 1000));
+    auto calls = fake.calls();
+
+    // The pause at 30 ms does not reach the driver.
+    ASSERT_EQ(2u, calls.size());
+    EXPECT_EQ(Op::PERFORM, calls[0].op);
+    EXPECT_EQ(31008u, calls[0].value);
+    EXPECT_EQ(255, calls[0].strength);
+    EXPECT_EQ(21000u, calls[1].value);
+    EXPECT_EQ(128, calls[1].strength);
+
+    EXPECT_LT(calls[0].timeNs - startNs, kSlackNs);
+    EXPECT_GE(calls[1].timeNs - startNs, 60 * 1000000LL);
+    EXPECT_LT(calls[1].timeNs - startNs, 60 * 1000000LL + kSlackNs);
+}
+
+TEST(ComposerTest, CancelDropsPendingSteps) {
+    FakeVibratorDevice fake;
+    Composer composer(fake.device());
+
+    composer.start({{0, 31008, 255}, {50, 21000, 128}});
+    ASSERT_TRUE(fake.waitForCalls(1, 1000));
+    composer.cancel();
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    EXPECT_EQ(1u, fake.calls().size());
+}
+
+TEST(ComposerTest, CancelWaitsForStepInFlight) {
+    FakeVibratorDevice fake;
+    Composer composer(fake.device());
+
+    fake.setLatencyUs(50000);
+    composer.start({{0, 31008, 255}});
+    ASSERT_TRUE(fake.waitForCalls(1, 1000));
+
+    int64_t callNs = fake.calls()[0].timeNs;
+    composer.cancel();
+    EXPECT_GE(monotonicNs() - callNs, 50 * 1000000LL);
+}
+
+TEST(ComposerTest, StartReplacesComposition) {
+    FakeVibratorDevice fake;
+    Composer composer(fake.device());
+
+    composer.start({{0, 31008, 255}, {50, 21000, 128}});
+    ASSERT_TRUE(fake.waitForCalls(1, 1000));
+    composer.start({{0, 30900, 64}});
+
+    ASSERT_TRUE(fake.waitForCalls(2, 1000));
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    auto calls = fake.calls();
+    ASSERT_EQ(2u, calls.size());
+    EXPECT_EQ(30900u, calls[1].value);
+}
+
+TEST(ComposerTest, CountsDriverErrors) {
+    FakeVibratorDevice fake;
+    Composer composer(fake.device());
+
+    fake.setResult(-EIO);
+    composer.start({{0, 31008, 255}, {10, 21000, 128}});
+    ASSERT_TRUE(fake.waitForCalls(2, 1000));
+    composer.cancel();
+
+    EXPECT_EQ(2u, composer.errors());
+    composer.resetStats();
+    EXPECT_EQ(0u, composer.errors());
+}
+
+TEST(ComposerTest, StrengthForScale) {
+    EXPECT_EQ(0, Composer::strengthForScale(0.0f));
+    EXPECT_EQ(128, Composer::strengthForScale(0.5f));
+    EXPECT_EQ(255, Composer::strengthForScale(1.0f));
+}
+
+}  // anonymous namespace
@@ -0,0 +1,190 @@
+/*
+ * Copyright (C) 2020 The MoKee Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <android-base/file.h>
+#include <android-base/test_utils.h>
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "EffectTable.h"
+
+using android::base::WriteStringToFile;
+using meizu::sm8150::EffectInfo;
+using meizu::sm8150::EffectTable;
+
+namespace {
+
+// Every V1_2::Effect by value. V1_0 ends at DOUBLE_CLICK and V1_1 at TICK.
+constexpr const char *kEffectNames[] = {
+        "CLICK",       "DOUBLE_CLICK", "TICK",        "THUD",        "POP",
+        "HEAVY_CLICK", "RINGTONE_1",   "RINGTONE_2",  "RINGTONE_3",  "RINGTONE_4",
+        "RINGTONE_5",  "RINGTONE_6",   "RINGTONE_7",  "RINGTONE_8",  "RINGTONE_9",
+        "RINGTONE_10", "RINGTONE_11",  "RINGTONE_12", "RINGTONE_13", "RINGTONE_14",
+        "RINGTONE_15",
+};
+constexpr uint32_t kV1_0EffectCount = 2;
+constexpr uint32_t kV1_1EffectCount = 3;
+constexpr uint32_t kV1_2EffectCount = sizeof(kEffectNames) / sizeof(kEffectNames[0]);
+
+// Every EffectStrength by value.
+constexpr const char *kStrengthNames[] = {"LIGHT", "MEDIUM", "STRONG"};
+constexpr uint32_t kStrengthCount = sizeof(kStrengthNames) / sizeof(kStrengthNames[0]);
+
+// What the HAL played before the table, by effect and strength.
+constexpr uint32_t kBuiltInIds[] = {31008, 31003, 21000, 30900, 22520, 30900};
+constexpr uint32_t kBuiltInCount = sizeof(kBuiltInIds) / sizeof(kBuiltInIds[0]);
+constexpr uint8_t kBuiltInStrengths[] = {50, 120, 255};
+
+bool load(EffectTable *table, const std::string &config) {
+    TemporaryFile file;
+
+    return WriteStringToFile(config, file.path) && table->load(file.path);
+}
+
+TEST(EffectTableTest, CoversEveryHidlValue) {
+    EXPECT_LE(kV1_2EffectCount, EffectTable::kEffectCount);
+    EXPECT_EQ(kStrengthCount, EffectTable::kStrengthCount);
+}
+
+TEST(EffectTableTest, BuiltInEffectsMatchThePreviousSwitch) {
+    EffectTable table;
+
+    for (uint32_t effect = 0; effect < kV1_2EffectCount; effect++) {
+        const EffectInfo *info = table.effect(effect);
+
+        if (effect >= kBuiltInCount) {
+            EXPECT_EQ(nullptr, info) << kEffectNames[effect];
+            continue;
+        }
+
+        ASSERT_NE(nullptr, info) << kEffectNames[effect];
+        EXPECT_EQ(kBuiltInIds[effect], info->id) << kEffectNames[effect];
+        EXPECT_GT(info->durationMs, 0u) << kEffectNames[effect];
+        EXPECT_LT(info->durationMs, 200u) << kEffectNames[effect];
+    }
+}
+
+// The V1_0 and V1_1 perform() calls share the V1_2 table, and support all their effects.
+TEST(EffectTableTest, EarlierVersionsAreSupported) {
+    EffectTable table;
+
+    for (uint32_t effect = 0; effect < kV1_0EffectCount; effect++) {
+        EXPECT_NE(nullptr, table.effect(effect)) << "V1_0 " << kEffectNames[effect];
+    }
+    for (uint32_t effect = kV1_0EffectCount; effect < kV1_1EffectCount; effect++) {
+        EXPECT_NE(nullptr, table.effect(effect)) << "V1_1 " << kEffectNames[effect];
+    }
+}
+
+TEST(EffectTableTest, BuiltInStrengthsMatchThePreviousSwitch) {
+    EffectTable table;
+
+    for (uint32_t effect = 0; effect < kV1_2EffectCount; effect++) {
+        for (uint32_t strength = 0; strength < kStrengthCount; strength++) {
+            uint8_t value = 0;
+
+            ASSERT_TRUE(table.strength(effect, strength, &value))
+                    << kEffectNames[effect] << " " << kStrengthNames[strength];
+            EXPECT_EQ(kBuiltInStrengths[strength], value)
+                    << kEffectNames[effect] << " " << kStrengthNames[strength];
+        }
+    }
+}
+
+TEST(EffectTableTest, RejectsOutOfRangeValues) {
+    EffectTable table;
+    uint8_t value;
+
+    EXPECT_EQ(nullptr, table.effect(EffectTable::kEffectCount));
+    EXPECT_FALSE(table.strength(EffectTable::kEffectCount, 0, &value));
+    EXPECT_FALSE(table.strength(0, kStrengthCount, &value));
+}
+
+TEST(EffectTableTest, LoadOverridesEveryEffect) {
+    EffectTable table;
+    std::string config;
+
+    for (uint32_t effect = 0; effect < kV1_2EffectCount; effect++) {
+        config += std::string("effect ") + kEffectNames[effect] + " " +
+                  std::to_string(1000 + effect) + " " + std::to_string(effect + 1) + "\n";
+    }
+    ASSERT_TRUE(load(&table, config));
+
+    for (uint32_t effect = 0; effect < kV1_2EffectCount; effect++) {
+        const EffectInfo *info = table.effect(effect);
+
+        ASSERT_NE(nullptr, info) << kEffectNames[effect];
+        EXPECT_EQ(1000 + effect, info->id) << kEffectNames[effect];
+        EXPECT_EQ(effect + 1, info->durationMs) << kEffectNames[effect];
+    }
+}
+
+TEST(EffectTableTest, LoadOverridesStrengths) {
+    EffectTable table;
+
+    ASSERT_TRUE(load(&table,
+                     "strength MEDIUM 100\n"
+                     "effect_strength TICK LIGHT 10\n"
+                     "effect_strength RINGTONE_15 STRONG 200\n"));
+
+    for (uint32_t effect = 0; effect < kV1_2EffectCount; effect++) {
+        for (uint32_t strength = 0; strength < kStrengthCount; strength++) {
+            uint8_t expected = kBuiltInStrengths[strength];
+            uint8_t value = 0;
+
+            if (strength == 1) {
+                expected = 100;
+            } else if (effect == 2 && strength == 0) {
+                expected = 10;
+            } else if (effect == 20 && strength == 2) {
+                expected = 200;
+            }
+
+            ASSERT_TRUE(table.strength(effect, strength, &value));
+            EXPECT_EQ(expected, value) << kEffectNames[effect] << " " << kStrengthNames[strength];
+        }
+    }
+}
+
+TEST(EffectTableTest, LoadSkipsInvalidLines) {
+    EffectTable table;
+
+    ASSERT_TRUE(load(&table,
+                     "# effect CLICK 1 1\n"
+                     "effect CLICK\n"
+                     "effect UNKNOWN 1 1\n"
+                     "strength LIGHT 256\n"
+                     "effect_strength CLICK HARD 10\n"
+                     "effect TICK 42 7\n"));
+
+    EXPECT_EQ(kBuiltInIds[0], table.effect(0)->id);
+    EXPECT_EQ(42u, table.effect(2)->id);
+    EXPECT_EQ(7u, table.effect(2)->durationMs);
+
+    uint8_t value = 0;
+    ASSERT_TRUE(table.strength(0, 0, &value));
+    EXPECT_EQ(kBuiltInStrengths[0], value);
+}
+
+TEST(EffectTableTest, MissingFileKeepsDefaults) {
+    EffectTable table;
+
+    EXPECT_FALSE(table.load("/nonexistent/effects.conf"));
+    EXPECT_EQ(kBuiltInIds[0], table.effect(0)->id);
+}
+
+}  // anonymous namespace
@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2020 The MoKee Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <meizu/LatencyHistogram.h>
+#include <unistd.h>
+
+#include <chrono>
+
+#include "FakeVibratorDevice.h"
+
+namespace meizu {
+namespace sm8150 {
+
+FakeVibratorDevice::FakeVibratorDevice()
+    : mDevice(), mLatencyUs(0), mResult(0), mRecordCalls(true), mCallCount(0) {
+    mDevice.base.vibrator_on = on;
+    mDevice.base.vibrator_off = off;
+    mDevice.base.vibrator_perform_effect = performEffect;
+    mDevice.owner = this;
+}
+
+std::vector<FakeVibratorDevice::Call> FakeVibratorDevice::calls() const {
+    std::lock_guard<std::mutex> lock(mLock);
+    return mCalls;
+}
+
+size_t FakeVibratorDevice::callCount() const {
+    std::lock_guard<std::mutex> lock(mLock);
+    return mCallCount;
+}
+
+void FakeVibratorDevice::clear() {
+    std::lock_guard<std::mutex> lock(mLock);
+    mCalls.clear();
+    mCallCount = 0;
+}
+
+bool FakeVibratorDevice::waitForCalls(size_t count, uint32_t timeoutMs) const {
+    std::unique_lock<std::mutex> lock(mLock);
+    return mCond.wait_for(lock, std::chrono::milliseconds(timeoutMs),
+                          [&] { return mCallCount >= count; });
+}
+
+int FakeVibratorDevice::on(vibrator_device_t *device, unsigned int timeoutMs) {
+    return reinterpret_cast<Device *>(device)->owner->record(Op::ON, timeoutMs, 0);
+}
+
+int FakeVibratorDevice::off(vibrator_device_t *device) {
+    return reinterpret_cast<Device *>(device)->owner->record(Op::OFF, 0, 0);
+}
+
+int FakeVibratorDevice::performEffect(vibrator_device_t *device, uint32_t effect,
+                                      uint8_t strength) {
+    return reinterpret_cast<Device *>(device)->owner->record(Op::PERFORM, effect, strength);
+}
+
+int FakeVibratorDevice::record(Op op, uint32_t value, uint8_t strength) {
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+        if (mRecordCalls.load()) {
+            mCalls.push_back({op, monotonicNs(), value, strength});
+        }
+        mCallCount++;
+    }
+    mCond.notify_all();
+
+    // Logged first, so that a call shows up while it is still blocked.
+    uint32_t latencyUs = mLatencyUs.load();
+    if (latencyUs > 0) {
+        usleep(latencyUs);
+    }
+
+    return mResult.load();
+}
+
+}  // namespace sm8150
+}  // namespace meizu
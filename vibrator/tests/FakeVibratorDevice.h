@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2020 The MoKee Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MEIZU_SM8150_VIBRATOR_TESTS_FAKEVIBRATORDEVICE_H
+#define MEIZU_SM8150_VIBRATOR_TESTS_FAKEVIBRATORDEVICE_H
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+#include "hardware/vibrator.h"
+
+namespace meizu {
+namespace sm8150 {
+
+/*
+ * A vibrator_device_t that records every call with a timestamp instead of
+ * driving the haptics hardware.
+ *
+ * Each call can be made to take a fixed time and to fail, to stand in for
+ * a slow or broken driver. Benchmarks that make millions of calls can turn
+ * the log off and keep only a count. Every method may be called from any
+ * thread.
+ */
+class FakeVibratorDevice {
+  public:
+    enum class Op { ON, OFF, PERFORM };
+
+    struct Call {
+        Op op;
+        // monotonicNs() when the call was made.
+        int64_t timeNs;
+        // The timeout of ON, the effect id of PERFORM.
+        uint32_t value;
+        uint8_t strength;
+    };
+
+    FakeVibratorDevice();
+
+    FakeVibratorDevice(const FakeVibratorDevice &) = delete;
+    FakeVibratorDevice &operator=(const FakeVibratorDevice &) = delete;
+
+    vibrator_device_t *device() { return &mDevice.base; }
+
+    // How long each call blocks before returning.
+    void setLatencyUs(uint32_t latencyUs) { mLatencyUs.store(latencyUs); }
+    // What each call returns, a negative errno or 0.
+    void setResult(int result) { mResult.store(result); }
+    // Whether calls() logs each call. Calls are counted either way.
+    void setRecordCalls(bool recordCalls) { mRecordCalls.store(recordCalls); }
+
+    std::vector<Call> calls() const;
+    size_t callCount() const;
+    void clear();
+
+    // Returns false if fewer than count calls were made within timeoutMs.
+    // A call counts as soon as it is made, before its latency has passed.
+    bool waitForCalls(size_t count, uint32_t timeoutMs) const;
+
+  private:
+    struct Device {
+        // First, so that the driver's vibrator_device_t pointer is ours.
+        vibrator_device_t base;
+        FakeVibratorDevice *owner;
+    };
+
+    static int on(vibrator_device_t *device, unsigned int timeoutMs);
+    static int off(vibrator_device_t *device);
+    static int performEffect(vibrator_device_t *device, uint32_t effect, uint8_t strength);
+
+    int record(Op op, uint32_t value, uint8_t strength);
+
+    Device mDevice;
+    std::atomic<uint32_t> mLatencyUs;
+    std::atomic<int> mResult;
+    std::atomic<bool> mRecordCalls;
+
+    mutable std::mutex mLock;
+    mutable std::condition_variable mCond;
+    std::vector<Call> mCalls;
+    size_t mCallCount;
+};
+
+}  // namespace sm8150
+}  // namespace meizu
+
+#endif  // MEIZU_SM8150_VIBRATOR_TESTS_FAKEVIBRATORDEVICE_H
@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) 2020 The MoKee Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+#include <meizu/LatencyHistogram.h>
+
+#include "FakeVibratorDevice.h"
+#include "VibratorCore.h"
+
+using meizu::sm8150::FakeVibratorDevice;
+using meizu::sm8150::LatencyHistogram;
+using meizu::sm8150::monotonicNs;
+using meizu::sm8150::VibratorCore;
+
+namespace {
+
+// Framework values of Effect::TICK and EffectStrength::MEDIUM.
+constexpr uint32_t kEffectTick = 2;
+constexpr uint32_t kStrengthMedium = 1;
+
+void reportTail(benchmark::State &state, const LatencyHistogram &latency) {
+    state.counters["p50_us"] = latency.percentileNs(50) / 1000.0;
+    state.counters["p99_us"] = latency.percentileNs(99) / 1000.0;
+    state.counters["p99.9_us"] = latency.percentileNs(99.9) / 1000.0;
+}
+
+/*
+ * perform() as seen by the binder thread, for a driver taking the given
+ * time per effect. The effect is only queued, so a slow driver should not
+ * show up here.
+ */
+void BM_perform(benchmark::State &state) {
+    FakeVibratorDevice fake;
+    VibratorCore core(fake.device(), {});
+    LatencyHistogram latency;
+    uint32_t durationMs;
+
+    fake.setLatencyUs(state.range(0));
+    fake.setRecordCalls(false);
+
+    for (auto _ : state) {
+        int64_t startNs = monotonicNs();
+        core.perform(kEffectTick, kStrengthMedium, &durationMs);
+        latency.record(monotonicNs() - startNs);
+    }
+
+    state.SetItemsProcessed(state.iterations());
+    reportTail(state, latency);
+}
+
+BENCHMARK(BM_perform)->ArgName("driver_us")->Arg(0)->Arg(100)->Arg(2000)->UseRealTime();
+
+/*
+ * on() followed by off(), which both call the driver on the binder thread.
+ */
+void BM_onOff(benchmark::State &state) {
+    FakeVibratorDevice fake;
+    VibratorCore core(fake.device(), {});
+    LatencyHistogram latency;
+
+    fake.setLatencyUs(state.range(0));
+    fake.setRecordCalls(false);
+
+    for (auto _ : state) {
+        int64_t startNs = monotonicNs();
+        core.on(100);
+        core.off();
+        latency.record(monotonicNs() - startNs);
+    }
+
+    state.SetItemsProcessed(state.iterations() * 2);
+    reportTail(state, latency);
+}
+
+BENCHMARK(BM_onOff)->ArgName("driver_us")->Arg(0)->Arg(100)->UseRealTime();
+
+/*
+ * An effect cut short by off(), which has to wait for the effect the
+ * worker is playing. The tail shows how long a slow driver holds it up.
+ */
+void BM_performThenOff(benchmark::State &state) {
+    FakeVibratorDevice fake;
+    VibratorCore core(fake.device(), {});
+    LatencyHistogram latency;
+    uint32_t durationMs;
+
+    fake.setLatencyUs(state.range(0));
+    fake.setRecordCalls(false);
+
+    for (auto _ : state) {
+        int64_t startNs = monotonicNs();
+        core.perform(kEffectTick, kStrengthMedium, &durationMs);
+        core.off();
+        latency.record(monotonicNs() - startNs);
+    }
+
+    state.SetItemsProcessed(state.iterations());
+    reportTail(state, latency);
+}
+
+BENCHMARK(BM_performThenOff)->ArgName("driver_us")->Arg(0)->Arg(100)->UseRealTime();
+
+}  // anonymous namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,172 @@
+/*
+ * Copyright (C) 2020 The MoKee Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <meizu/ScratchSysfs.h>
+
+#include "FakeVibratorDevice.h"
+#include "VibratorCore.h"
+
+using meizu::sm8150::FakeVibratorDevice;
+using meizu::sm8150::ScratchSysfs;
+using meizu::sm8150::VibratorCore;
+
+namespace {
+
+using Op = FakeVibratorDevice::Op;
+using Result = VibratorCore::Result;
+
+// Framework enum values.
+constexpr uint32_t kEffectClick = 0;
+constexpr uint32_t kEffectTick = 2;
+constexpr uint32_t kEffectRingtone1 = 6;
+constexpr uint32_t kStrengthLight = 0;
+constexpr uint32_t kStrengthStrong = 2;
+constexpr uint32_t kPrimitiveClick = 1;
+constexpr uint32_t kPrimitiveSpin = 3;
+
+constexpr const char *kGainPath = "/sys/class/leds/vibrator/gain";
+
+class VibratorCoreTest : public ::testing::Test {
+  protected:
+    VibratorCore::Config config(bool gain) {
+        VibratorCore::Config config;
+
+        config.sysfsRoot = mSysfs.root();
+        if (gain) {
+            mSysfs.create(kGainPath, "0");
+        }
+        return config;
+    }
+
+    std::string gain() { return mSysfs.read(kGainPath); }
+
+    ScratchSysfs mSysfs;
+    FakeVibratorDevice mFake;
+};
+
+TEST_F(VibratorCoreTest, PerformQueuesEffectWithItsStrength) {
+    VibratorCore core(mFake.device(), config(false));
+    uint32_t durationMs = 0;
+
+    ASSERT_EQ(Result::OK, core.perform(kEffectClick, kStrengthStrong, &durationMs));
+    EXPECT_EQ(20u, durationMs);
+
+    ASSERT_TRUE(mFake.waitForCalls(1, 1000));
+    auto calls = mFake.calls();
+    EXPECT_EQ(Op::PERFORM, calls[0].op);
+    EXPECT_EQ(31008u, calls[0].value);
+    EXPECT_EQ(255, calls[0].strength);
+}
+
+TEST_F(VibratorCoreTest, UnsupportedEffectsAndStrengths) {
+    VibratorCore core(mFake.device(), config(false));
+    uint32_t durationMs;
+
+    EXPECT_EQ(Result::UNSUPPORTED, core.perform(kEffectRingtone1, kStrengthLight, &durationMs));
+    EXPECT_EQ(Result::UNSUPPORTED, core.perform(kEffectTick, 3, &durationMs));
+    EXPECT_EQ(Result::UNSUPPORTED, core.perform(100, kStrengthLight, &durationMs));
+
+    auto effects = core.supportedEffects();
+    EXPECT_EQ(6u, effects.size());
+}
+
+TEST_F(VibratorCoreTest, AmplitudeNeedsGainNode) {
+    VibratorCore core(mFake.device(), config(false));
+
+    EXPECT_FALSE(core.supportsAmplitudeControl());
+    EXPECT_EQ(Result::UNSUPPORTED, core.setAmplitude(0.5f));
+}
+
+TEST_F(VibratorCoreTest, AmplitudeMapsToGain) {
+    VibratorCore core(mFake.device(), config(true));
+
+    ASSERT_TRUE(core.supportsAmplitudeControl());
+    EXPECT_EQ(Result::OK, core.setAmplitude(1.0f));
+    EXPECT_EQ("128", gain());
+    EXPECT_EQ(Result::OK, core.setAmplitude(0.5f));
+    EXPECT_EQ("64", gain());
+
+    // Never 0, which would silence the motor.
+    EXPECT_EQ(Result::OK, core.setAmplitude(0.001f));
+    EXPECT_EQ("1", gain());
+
+    EXPECT_EQ(Result::BAD_VALUE, core.setAmplitude(0.0f));
+    EXPECT_EQ(Result::BAD_VALUE, core.setAmplitude(1.5f));
+}
+
+TEST_F(VibratorCoreTest, OnRestoresGainAfterEffect) {
+    VibratorCore core(mFake.device(), config(true));
+    uint32_t durationMs;
+
+    ASSERT_EQ(Result::OK, core.setAmplitude(0.5f));
+    ASSERT_EQ(Result::OK, core.perform(kEffectTick, kStrengthLight, &durationMs));
+
+    // The driver may have changed the gain for the effect.
+    mSysfs.write(kGainPath, "128");
+
+    ASSERT_EQ(Result::OK, core.on(500));
+    EXPECT_EQ("64", gain());
+}
+
+TEST_F(VibratorCoreTest, OffWaitsForEffectInFlight) {
+    VibratorCore core(mFake.device(), config(false));
+    uint32_t durationMs;
+
+    mFake.setLatencyUs(50000);
+    ASSERT_EQ(Result::OK, core.perform(kEffectClick, kStrengthLight, &durationMs));
+    ASSERT_TRUE(mFake.waitForCalls(1, 1000));
+
+    ASSERT_EQ(Result::OK, core.off());
+
+    // off() reaches the driver only once the effect has returned.
+    auto calls = mFake.calls();
+    ASSERT_EQ(2u, calls.size());
+    EXPECT_EQ(Op::PERFORM, calls[0].op);
+    EXPECT_EQ(Op::OFF, calls[1].op);
+    EXPECT_GE(calls[1].timeNs - calls[0].timeNs, 50000000);
+}
+
+TEST_F(VibratorCoreTest, DriverErrorsFailTheCall) {
+    VibratorCore core(mFake.device(), config(false));
+
+    mFake.setResult(-EIO);
+    EXPECT_EQ(Result::FAILED, core.on(100));
+    EXPECT_EQ(Result::FAILED, core.off());
+
+    std::string dump = core.dump([](uint32_t effect) { return std::to_string(effect); });
+    EXPECT_NE(std::string::npos, dump.find("on errors=1")) << dump;
+    EXPECT_NE(std::string::npos, dump.find("off errors=1")) << dump;
+}
+
+TEST_F(VibratorCoreTest, ComposeValidatesPrimitives) {
+    VibratorCore core(mFake.device(), config(false));
+    uint32_t durationMs;
+
+    EXPECT_EQ(Result::UNSUPPORTED, core.compose({{kPrimitiveSpin, 1.0f, 0}}, &durationMs));
+    EXPECT_EQ(Result::BAD_VALUE, core.compose({{kPrimitiveClick, 1.5f, 0}}, &durationMs));
+    EXPECT_EQ(Result::BAD_VALUE, core.compose({{kPrimitiveClick, 1.0f, 1001}}, &durationMs));
+    EXPECT_EQ(Result::BAD_VALUE,
+              core.compose(std::vector<VibratorCore::Primitive>(17, {kPrimitiveClick, 1.0f, 0}),
+                           &durationMs));
+
+    ASSERT_EQ(Result::OK,
+              core.compose({{kPrimitiveClick, 1.0f, 0}, {kPrimitiveClick, 0.5f, 10}}, &durationMs));
+    // CLICK plays for 20 ms, followed by a 10 ms delay and a second CLICK.
+    EXPECT_EQ(50u, durationMs);
+}
+
+}  // anonymous namespace